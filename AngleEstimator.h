@@ -0,0 +1,160 @@
+#pragma once
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Rotor angle estimator: an alpha-beta-gamma tracker on Hall sync times.
+//
+// State per revolution: filtered sync time, period and period change (the
+// acceleration term), so the next revolution's spoke period is predicted
+// instead of lagging behind an average during spin-up/down.  A pulse whose
+// residual is too large for the current lock is rejected (bounce, missed or
+// double magnet pulse); a run of rejects means the rotor really changed and
+// the tracker re-acquires.  Header-only, no Arduino, so the replay below runs
+// on a host as well as on the device.
+
+struct AngleEstimatorCfg {
+  float    alpha     = 0.50f;   // time residual gain
+  float    beta      = 0.20f;   // period gain
+  float    gamma     = 0.02f;   // period-change gain
+  float    rejectFrac = 0.25f;  // reject a pulse |residual| > rejectFrac * period
+  uint8_t  reacquire = 3;       // consecutive rejects before re-acquiring
+  uint32_t minPeriodUs = 2000;  // faster than 30000 rpm: noise
+  uint32_t maxPeriodUs = 2000000;  // slower than 30 rpm: stopped
+};
+
+class AngleEstimator {
+public:
+  explicit AngleEstimator(const AngleEstimatorCfg& cfg = AngleEstimatorCfg()) : _cfg(cfg) {}
+
+  void reset() { _n = 0; _rejectRun = 0; _period = 0; _dPeriod = 0; }
+
+  // Feed one sync timestamp.  false when it was rejected as an outlier (the
+  // caller keeps its schedule running as if the pulse had not happened).
+  bool update(uint32_t tUs) {
+    if (_n == 0) { _t = tUs; _n = 1; return true; }
+    const float dt = (float)(int32_t)(tUs - _t);
+    if (_n == 1) {
+      if (dt < _cfg.minPeriodUs || dt > _cfg.maxPeriodUs) { _t = tUs; return true; }
+      _t = tUs; _period = dt; _dPeriod = 0; _n = 2;
+      return true;
+    }
+    const float predT = _period + 0.5f * _dPeriod;           // predicted interval
+    // Missed pulses: coast whole revolutions up to this one
+    const long m = lroundf(dt / predT);
+    if (m >= 2 && m <= 8 && fabsf(dt - m * predT) <= _cfg.rejectFrac * _period) {
+      for (long i = 1; i < m; ++i) { _t += (uint32_t)(int32_t)lroundf(predT); _period += _dPeriod; }
+      ++_coasted;
+      return update(tUs);
+    }
+    const float r = dt - predT;
+    if (fabsf(r) > _cfg.rejectFrac * _period || dt < _cfg.minPeriodUs || dt > _cfg.maxPeriodUs) {
+      ++_rejected;
+      if (++_rejectRun >= _cfg.reacquire) { reset(); update(tUs); }
+      return false;
+    }
+    _rejectRun = 0;
+    // Filtered time of this sync, then period and its change per revolution
+    _t = _t + (uint32_t)(int32_t)lroundf(predT + _cfg.alpha * r);
+    _period  = _period + _dPeriod + _cfg.beta * r;
+    _dPeriod = _dPeriod + 2.0f * _cfg.gamma * r;
+    if (_n < 255) ++_n;
+    return true;
+  }
+
+  bool     locked()    const { return _n >= 3; }
+  bool     hasPeriod() const { return _n >= 2; }
+  uint32_t syncUs()    const { return _t; }
+  float    periodUs()  const { return _period; }
+  float    dPeriodUs() const { return _dPeriod; }
+  uint32_t rejected()  const { return _rejected; }
+  uint32_t coasted()   const { return _coasted; }
+
+  // Mean period of the revolution that starts at syncUs()
+  float nextPeriodUs() const { return _period + 0.5f * _dPeriod; }
+
+  // The schedule the spinner runs: evenly spaced spokes of the mean period,
+  // anchored at syncUs() (SpokeScheduler::sync(syncUs(), spokeUs(spokes), spokes))
+  uint32_t spokeUs(uint16_t spokes) const {
+    const uint32_t rev = (uint32_t)lroundf(nextPeriodUs());
+    const uint32_t d = spokes ? rev / spokes : rev;
+    return d ? d : 1;
+  }
+  uint32_t spokeTimeUs(uint16_t k, uint16_t spokes) const { return _t + (uint32_t)k * spokeUs(spokes); }
+
+private:
+  AngleEstimatorCfg _cfg;
+  uint32_t _t = 0;
+  float    _period = 0, _dPeriod = 0;
+  uint8_t  _n = 0;
+  uint8_t  _rejectRun = 0;
+  uint32_t _rejected = 0;
+  uint32_t _coasted  = 0;
+};
+
+// The original spoke timing: 3/4 EMA of the raw period, restarted at every
+// raw pulse.  Kept as the baseline for replays.
+struct LegacySpokeEma {
+  uint32_t t = 0, spokeUs = 0;
+  bool     have = false;
+  void update(uint32_t tUs, uint16_t spokes) {
+    if (have && spokes) {
+      uint32_t d = (tUs - t) / spokes;
+      if (!d) d = 1;
+      spokeUs = spokeUs ? (uint32_t)(((uint64_t)spokeUs * 3 + d) / 4) : d;
+    }
+    t = tUs; have = true;
+  }
+  uint32_t spokeTimeUs(uint16_t k) const { return t + (uint32_t)k * spokeUs; }
+};
+
+// Angular error of scheduled spoke starts against a recorded trace.  Truth
+// for revolution i is linear in time between sync i and sync i+1; a spoke
+// scheduled for angle k/spokes lands where the rotor really was at that time.
+// The tracker is scored on the schedule the device runs (spokeTimeUs()).
+struct ReplayStats {
+  uint32_t revs = 0, spokes = 0, rejected = 0;
+  float    meanAbsDeg = 0, rmsDeg = 0, maxAbsDeg = 0;
+};
+
+static inline void replayAccum(ReplayStats& s, double& sumAbs, double& sumSq, float errDeg) {
+  const float a = fabsf(errDeg);
+  sumAbs += a; sumSq += (double)errDeg * errDeg;
+  if (a > s.maxAbsDeg) s.maxAbsDeg = a;
+  ++s.spokes;
+}
+
+static inline void replayFinish(ReplayStats& s, double sumAbs, double sumSq) {
+  if (!s.spokes) return;
+  s.meanAbsDeg = (float)(sumAbs / s.spokes);
+  s.rmsDeg     = (float)sqrt(sumSq / s.spokes);
+}
+
+// ts: sync timestamps (us).  est/legacy: results for the tracker and the
+// old EMA over the same revolutions (the first `warmup` are skipped).
+static inline void replayHallTrace(const uint32_t* ts, size_t n, uint16_t spokes, const AngleEstimatorCfg& cfg,
+                                   ReplayStats& est, ReplayStats& legacy, uint8_t warmup = 4) {
+  est = ReplayStats(); legacy = ReplayStats();
+  if (n < 2 || !spokes) return;
+  AngleEstimator ae(cfg);
+  LegacySpokeEma ema;
+  double eAbs = 0, eSq = 0, lAbs = 0, lSq = 0;
+  for (size_t i = 0; i + 1 < n; ++i) {
+    const bool ok = ae.update(ts[i]);
+    ema.update(ts[i], spokes);
+    if (!ok || i < warmup || !ae.locked() || !ema.spokeUs) continue;
+    const float revUs = (float)(int32_t)(ts[i + 1] - ts[i]);
+    if (revUs <= 0) continue;
+    for (uint16_t k = 0; k < spokes; ++k) {
+      const float want = 360.0f * k / spokes;
+      const float gotE = 360.0f * (float)(int32_t)(ae.spokeTimeUs(k, spokes) - ts[i]) / revUs;
+      const float gotL = 360.0f * (float)(int32_t)(ema.spokeTimeUs(k) - ts[i]) / revUs;
+      replayAccum(est, eAbs, eSq, gotE - want);
+      replayAccum(legacy, lAbs, lSq, gotL - want);
+    }
+    ++est.revs; ++legacy.revs;
+  }
+  est.rejected = ae.rejected();
+  replayFinish(est, eAbs, eSq);
+  replayFinish(legacy, lAbs, lSq);
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Bit transposition for parallel LED output.
+//
+// Up to 8 byte streams (one per arm) become one stream of bus words: for
+// every source byte j there are 8 output bytes, MSB first, and bit k of
+// output byte j*8+b is bit (7-b) of stream k's byte j.  Clocking those bytes
+// onto an 8-bit parallel bus sends every stream at once on its own data line.
+// Header-only and Arduino-free so it can be exercised on a host.
+
+// 8x8 bit-matrix transpose: bit c of byte r <-> bit r of byte c
+static inline uint64_t bitTranspose8x8(uint64_t x) {
+  uint64_t t;
+  t = (x ^ (x >> 7))  & 0x00AA00AA00AA00AAULL; x = x ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL; x = x ^ t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL; x = x ^ t ^ (t << 28);
+  return x;
+}
+
+// src[k] may be nullptr for an unused line (sent as zeros).  dst: bytes*8.
+static inline void transposeStreams8(const uint8_t* const* src, uint8_t lanes, size_t bytes, uint8_t* dst) {
+  if (lanes > 8) lanes = 8;
+  for (size_t j = 0; j < bytes; ++j, dst += 8) {
+    uint64_t x = 0;
+    for (uint8_t k = 0; k < lanes; ++k) if (src[k]) x |= (uint64_t)src[k][j] << (8 * k);
+    x = bitTranspose8x8(x);
+    for (uint8_t b = 0; b < 8; ++b) dst[b] = (uint8_t)(x >> (8 * (7 - b)));
+  }
+}
+
+// Inverse of transposeStreams8 (round-trip checks)
+static inline void untransposeStreams8(const uint8_t* src, size_t bytes, uint8_t lanes, uint8_t* const* dst) {
+  if (lanes > 8) lanes = 8;
+  for (size_t j = 0; j < bytes; ++j, src += 8) {
+    uint64_t x = 0;
+    for (uint8_t b = 0; b < 8; ++b) x |= (uint64_t)src[b] << (8 * (7 - b));
+    x = bitTranspose8x8(x);
+    for (uint8_t k = 0; k < lanes; ++k) if (dst[k]) dst[k][j] = (uint8_t)(x >> (8 * k));
+  }
+}
+
+// Round trip plus a bit-exact reference check on pseudo-random streams.
+// Returns true when both agree.
+static inline bool bitTransposeSelfTest() {
+  enum { LANES = 8, BYTES = 37 };
+  uint8_t in[LANES][BYTES], back[LANES][BYTES], bus[BYTES * 8];
+  uint32_t s = 0x12345678u;
+  for (int k = 0; k < LANES; ++k)
+    for (int j = 0; j < BYTES; ++j) { s ^= s << 13; s ^= s >> 17; s ^= s << 5; in[k][j] = (uint8_t)s; }
+
+  const uint8_t* src[LANES]; uint8_t* dst[LANES];
+  for (int k = 0; k < LANES; ++k) { src[k] = in[k]; dst[k] = back[k]; }
+  transposeStreams8(src, LANES, BYTES, bus);
+
+  for (int j = 0; j < BYTES; ++j)
+    for (int b = 0; b < 8; ++b)
+      for (int k = 0; k < LANES; ++k)
+        if (((bus[j * 8 + b] >> k) & 1) != ((in[k][j] >> (7 - b)) & 1)) return false;
+
+  memset(back, 0, sizeof(back));
+  untransposeStreams8(bus, BYTES, LANES, dst);
+  return memcmp(in, back, sizeof(in)) == 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <stdint.h>
+
+// Sequence frame clock.  The frame period is a ratio (num/den microseconds,
+// e.g. 25000/1 for a 25 ms FSEQ step, 1000000/30 for 30 fps) and elapsed time
+// goes into a fractional accumulator, so nothing is rounded away per frame and
+// the clock never drifts from the sequence timebase.  advance() returns how
+// many frames came due; the caller jumps that far even if it was late, so a
+// stall drops frames instead of stretching the show.  No Arduino; wraps with
+// the 32-bit microsecond clock.
+
+class FrameClock {
+public:
+  void setRate(uint32_t num, uint32_t den) {
+    _num = num ? num : 1;
+    _den = den ? den : 1;
+    if (_acc >= _num) _acc %= _num;
+  }
+
+  // Frame boundary at nowUs (call when a frame goes on screen)
+  void start(uint32_t nowUs) { _last = nowUs; _acc = 0; _running = true; }
+  bool running() const { return _running; }
+
+  // Frames that came due since the last call
+  uint32_t advance(uint32_t nowUs) {
+    if (!_running) return 0;
+    const uint32_t dt = nowUs - _last;
+    _last = nowUs;
+    _acc += (uint64_t)dt * _den;
+    if (_acc < _num) return 0;
+    const uint64_t n = _acc / _num;
+    _acc -= n * _num;
+    return n > UINT32_MAX ? UINT32_MAX : (uint32_t)n;
+  }
+
+  uint32_t periodNum() const { return _num; }
+  uint32_t periodDen() const { return _den; }
+
+private:
+  uint32_t _num = 25000, _den = 1;
+  uint64_t _acc = 0;      // elapsed us * den since the last frame boundary
+  uint32_t _last = 0;
+  bool     _running = false;
+};
+
+// Signed distance from frame `f` to frame `clock` on a looping sequence of
+// `count` frames: > 0 when f is behind the clock, 0 due now, < 0 still early.
+static inline int32_t frameLag(uint32_t f, uint32_t clock, uint32_t count) {
+  if (!count) return 0;
+  uint32_t d = (clock + count - (f % count)) % count;
+  return d > count / 2 ? (int32_t)d - (int32_t)count : (int32_t)d;
+}
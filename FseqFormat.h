@@ -0,0 +1,172 @@
+#pragma once
+#include <algorithm>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// FSEQ v2 container: fixed header, compression-block table, sparse ranges.
+// Decoding and indexing only; the caller owns the file and the buffers, so
+// the same code runs in the player (SD_MMC File) and in a host build (a
+// mock File over a byte buffer).  Portable (no Arduino).
+//
+//   [0, 32)  header, little-endian, see fseqDecodeHeader()
+//   [32, ..) compBlockCnt x { u32 first frame (or uncompressed size), u32 compressed size }
+//            sparseCnt    x { u24 start channel, u24 channel count }
+//   chanDataOffset: frame data (raw frames, or the compressed blocks in order)
+
+static const uint8_t FSEQ_HEADER_BYTES     = 32;
+static const uint8_t FSEQ_COMP_ENTRY_BYTES = 8;
+static const uint8_t FSEQ_RANGE_BYTES      = 6;
+
+struct SparseRange { uint32_t start, count, accum; };
+struct CompBlock    { uint32_t uSize, cSize; };
+
+struct FseqHeader {
+  uint16_t chanDataOffset = 0;
+  uint8_t  minor = 0, major = 2;
+  uint16_t varDataOffset = 0;
+  uint32_t channelCount = 0;
+  uint32_t frameCount   = 0;
+  uint8_t  stepTimeMs   = 25;
+  uint8_t  flags        = 0;
+  uint8_t  compType     = 0;     // 0=none, 1=zstd, 2=zlib
+  uint16_t compBlockCnt = 0;     // 12-bit: low byte + high nibble of the compression byte
+  uint8_t  sparseCnt    = 0;
+  uint64_t uniqueId     = 0;
+};
+
+static inline uint16_t fseqGet16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static inline uint32_t fseqGet24(const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16); }
+static inline uint32_t fseqGet32(const uint8_t* p) { return (uint32_t)fseqGet16(p) | ((uint32_t)fseqGet16(p + 2) << 16); }
+static inline uint64_t fseqGet64(const uint8_t* p) { return (uint64_t)fseqGet32(p) | ((uint64_t)fseqGet32(p + 4) << 32); }
+
+// nullptr when raw is an FSEQ header, else the reason
+static inline const char* fseqDecodeHeader(const uint8_t raw[FSEQ_HEADER_BYTES], FseqHeader& h) {
+  if (!((raw[0] == 'F' || raw[0] == 'P') && raw[1] == 'S' && raw[2] == 'E' && raw[3] == 'Q')) return "bad magic";
+  h.chanDataOffset = fseqGet16(raw + 4);
+  h.minor          = raw[6];
+  h.major          = raw[7];
+  h.varDataOffset  = fseqGet16(raw + 8);
+  h.channelCount   = fseqGet32(raw + 10);
+  h.frameCount     = fseqGet32(raw + 14);
+  h.stepTimeMs     = raw[18];
+  h.flags          = raw[19];
+  h.compType       = raw[20] & 0x0F;
+  h.compBlockCnt   = (uint16_t)raw[21] | ((uint16_t)(raw[20] & 0xF0) << 4);
+  h.sparseCnt      = raw[22];
+  h.uniqueId       = fseqGet64(raw + 24);
+  return nullptr;
+}
+
+static inline CompBlock fseqDecodeCompBlock(const uint8_t raw[FSEQ_COMP_ENTRY_BYTES]) {
+  CompBlock b = { fseqGet32(raw), fseqGet32(raw + 4) };
+  return b;
+}
+
+// accum: channels of the ranges before this one (its offset in a frame)
+static inline SparseRange fseqDecodeRange(const uint8_t raw[FSEQ_RANGE_BYTES], uint32_t accum) {
+  SparseRange r = { fseqGet24(raw), fseqGet24(raw + 3), accum };
+  return r;
+}
+
+// xLights pads the table with empty entries; they are not blocks
+static inline uint32_t fseqTrimBlocks(const CompBlock* cb, uint32_t n) {
+  while (n && cb[n - 1].cSize == 0) --n;
+  return n;
+}
+
+// offs[i] = file offset of block i, offs[n] = end of the last block
+static inline void fseqBlockOffsets(const CompBlock* cb, uint32_t n, uint64_t base, uint64_t* offs) {
+  for (uint32_t i = 0; i < n; ++i) { offs[i] = base; base += cb[i].cSize; }
+  offs[n] = base;
+}
+
+// The first word of each compression-table entry is the block's first frame
+// number in xLights exports (entry 0 is therefore 0); older exporters wrote the
+// uncompressed size.  Both are normalised into first[] (n + 1 entries, the last
+// = frames); maxFrames is the frame count of the largest block.  nullptr or
+// the reason the table does not describe this file.
+static inline const char* fseqBuildBlockIndex(const CompBlock* cb, uint32_t n, uint32_t chans, uint32_t frames,
+                                              uint32_t* first, uint32_t& maxFrames) {
+  maxFrames = 0;
+  if (!chans || !frames) return "zero chans";
+  if (!n) return "no blocks";
+  const bool frameNumbers = (cb[0].uSize == 0);
+  uint32_t f = 0;
+  for (uint32_t i = 0; i < n; ++i) {
+    if (frameNumbers) f = cb[i].uSize;
+    first[i] = f;
+    if (!frameNumbers) {
+      if (cb[i].uSize % chans) return "block size";
+      f += cb[i].uSize / chans;
+    }
+  }
+  if (!frameNumbers && f != frames) return "block sizes";
+  first[n] = frames;
+  for (uint32_t i = 0; i < n; ++i) {
+    if (first[i + 1] <= first[i]) return "block order";
+    const uint32_t k = first[i + 1] - first[i];
+    if (k > maxFrames) maxFrames = k;
+  }
+  return nullptr;
+}
+
+// Block holding frame idx: identity for per-frame files, else bisection
+static inline uint32_t fseqFrameBlock(const uint32_t* first, uint32_t n, bool perFrame, uint32_t idx) {
+  if (perFrame) return idx;
+  uint32_t lo = 0, hi = n;   // first[lo] <= idx < first[hi]
+  while (hi - lo > 1) {
+    const uint32_t mid = (lo + hi) / 2;
+    if (first[mid] <= idx) lo = mid; else hi = mid;
+  }
+  return lo;
+}
+
+/* ---- Sparse channel translation ---- */
+// Sparse exports carry up to 255 ranges.  Big non-overlapping sets are
+// searched by bisection in a start-sorted copy; small or overlapping sets keep
+// the file-order linear scan (first match wins).
+enum SparseXlateMode : uint8_t { XLATE_DENSE = 0, XLATE_LINEAR = 1, XLATE_BSEARCH = 2 };
+static const uint8_t SPARSE_BSEARCH_MIN = 8;   // below this a linear scan is cheaper
+
+static inline const char* sparseModeName(uint8_t mode) {
+  switch (mode) {
+    case XLATE_LINEAR:  return "linear";
+    case XLATE_BSEARCH: return "bsearch";
+    default:            return "dense";
+  }
+}
+
+// Mode for n ranges.  sorted (n entries, may be null) receives the sorted
+// copy; only XLATE_BSEARCH uses it.
+static inline uint8_t fseqIndexSparse(const SparseRange* ranges, uint8_t n, SparseRange* sorted) {
+  if (!n || !ranges) return XLATE_DENSE;
+  if (n < SPARSE_BSEARCH_MIN || !sorted) return XLATE_LINEAR;
+  memcpy(sorted, ranges, sizeof(SparseRange) * n);
+  std::sort(sorted, sorted + n, [](const SparseRange& a, const SparseRange& b) { return a.start < b.start; });
+  for (uint8_t i = 1; i < n; ++i)
+    if ((uint64_t)sorted[i - 1].start + sorted[i - 1].count > sorted[i].start) return XLATE_LINEAR;   // overlap
+  return XLATE_BSEARCH;
+}
+
+// Frame index of absolute channel absCh, -1 when the file does not carry it
+static inline int64_t fseqSparseTranslate(uint8_t mode, const SparseRange* ranges, const SparseRange* sorted,
+                                          uint8_t n, uint32_t chans, uint32_t absCh) {
+  if (mode == XLATE_DENSE) return (absCh < chans) ? (int64_t)absCh : -1;
+  if (mode == XLATE_BSEARCH) {
+    // last range with start <= absCh
+    uint32_t lo = 0, hi = n;
+    while (lo < hi) {
+      const uint32_t mid = (lo + hi) >> 1;
+      if (sorted[mid].start <= absCh) lo = mid + 1; else hi = mid;
+    }
+    if (!lo) return -1;
+    const SparseRange& r = sorted[lo - 1];
+    return (absCh - r.start < r.count) ? (int64_t)r.accum + (absCh - r.start) : -1;
+  }
+  for (uint8_t i = 0; i < n; ++i) {
+    const SparseRange& r = ranges[i];
+    if (absCh >= r.start && absCh < r.start + r.count) return (int64_t)r.accum + (absCh - r.start);
+  }
+  return -1;
+}
@@ -0,0 +1,106 @@
+#include "HallCapture.h"
+
+#if defined(ESP_PLATFORM)
+#include <Arduino.h>
+
+/* -------------------- ISR side -------------------- */
+void IRAM_ATTR HallCapture::push(uint32_t ticks, uint32_t isrUs) {
+  const HallEdge e = { ticks, isrUs };
+  _ring.push(e);
+}
+
+bool IRAM_ATTR HallCapture::onCapture(mcpwm_cap_channel_handle_t, const mcpwm_capture_event_data_t* ev, void* ctx) {
+  HallCapture* self = (HallCapture*)ctx;
+  self->push(ev->cap_value, micros());
+  BaseType_t woken = pdFALSE;
+  if (self->_notify && *self->_notify) vTaskNotifyGiveFromISR(*self->_notify, &woken);
+  return woken == pdTRUE;
+}
+
+void IRAM_ATTR HallCapture::onGpio(void* ctx) {
+  HallCapture* self = (HallCapture*)ctx;
+  const uint32_t now = micros();
+  self->push(now, now);
+  BaseType_t woken = pdFALSE;
+  if (self->_notify && *self->_notify) vTaskNotifyGiveFromISR(*self->_notify, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+
+/* -------------------- Setup / teardown -------------------- */
+bool HallCapture::startMcpwm(int pin, uint8_t edgeMode) {
+  mcpwm_capture_timer_config_t tcfg = {};
+  tcfg.clk_src  = MCPWM_CAPTURE_CLK_SRC_DEFAULT;
+  tcfg.group_id = 0;
+  if (mcpwm_new_capture_timer(&tcfg, &_timer) != ESP_OK) { _timer = nullptr; return false; }
+
+  uint32_t hz = 0;
+  mcpwm_capture_timer_get_resolution(_timer, &hz);
+  // The tick -> micros() mapping below needs a whole number of ticks per us
+  if (hz < 1000000 || hz % 1000000) { end(); return false; }
+  _tpu = hz / 1000000;
+
+  mcpwm_capture_channel_config_t ccfg = {};
+  ccfg.gpio_num       = pin;
+  ccfg.prescale       = 1;
+  ccfg.flags.neg_edge = (edgeMode == 0 || edgeMode == 2);
+  ccfg.flags.pos_edge = (edgeMode == 1 || edgeMode == 2);
+  ccfg.flags.pull_up  = true;
+  if (mcpwm_new_capture_channel(_timer, &ccfg, &_chan) != ESP_OK) { _chan = nullptr; end(); return false; }
+
+  mcpwm_capture_event_callbacks_t cbs = {};
+  cbs.on_cap = onCapture;
+  if (mcpwm_capture_channel_register_event_callbacks(_chan, &cbs, this) != ESP_OK ||
+      mcpwm_capture_channel_enable(_chan) != ESP_OK ||
+      mcpwm_capture_timer_enable(_timer) != ESP_OK ||
+      mcpwm_capture_timer_start(_timer) != ESP_OK) { end(); return false; }
+  return true;
+}
+
+bool HallCapture::begin(int pin, uint8_t edgeMode, TaskHandle_t* notify) {
+  end();
+  _notify  = notify;
+  _haveOff = false;
+  if (startMcpwm(pin, edgeMode)) { _source = "mcpwm"; return true; }
+
+  Serial.println("[HALL] MCPWM capture unavailable, using GPIO interrupt");
+  _tpu = 1;
+  pinMode(pin, INPUT_PULLUP);
+  const int mode = (edgeMode == 1) ? RISING : (edgeMode == 2 ? CHANGE : FALLING);
+  attachInterruptArg(digitalPinToInterrupt(pin), onGpio, this, mode);
+  _gpioPin = pin;
+  _source  = "gpio";
+  return true;
+}
+
+void HallCapture::end() {
+  if (_timer) mcpwm_capture_timer_stop(_timer);
+  if (_chan) {
+    mcpwm_capture_channel_disable(_chan);
+    mcpwm_del_capture_channel(_chan);
+    _chan = nullptr;
+  }
+  if (_timer) {
+    mcpwm_capture_timer_disable(_timer);
+    mcpwm_del_capture_timer(_timer);
+    _timer = nullptr;
+  }
+  if (_gpioPin >= 0) { detachInterrupt(digitalPinToInterrupt(_gpioPin)); _gpioPin = -1; }
+  _source = "none";
+}
+
+/* -------------------- Consumer side -------------------- */
+bool HallCapture::pop(uint32_t& us) {
+  HallEdge e;
+  if (!_ring.pop(e)) return false;
+  if (_tpu <= 1) { us = e.isrUs; return true; }
+  // d = ticks from the edge to the ISR's micros() read, plus a fixed offset
+  // between the two clocks (both run off the crystal, so it does not drift).
+  // The smallest d seen is that offset plus the least latency; anything on
+  // top is ISR jitter and is taken back off the timestamp.
+  const uint32_t d = e.isrUs * _tpu - e.ticks;
+  int32_t lag = (int32_t)(d - _off);
+  if (!_haveOff || lag < 0 || lag > (int32_t)(1000 * _tpu)) { _off = d; _haveOff = true; lag = 0; }
+  us = e.isrUs - ((uint32_t)lag + _tpu / 2) / _tpu;
+  return true;
+}
+#endif
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Hall edge capture.
+//
+// Every edge goes into a lock-free single-producer / single-consumer ring:
+// the capture ISR pushes, the render task pops, nobody masks interrupts and
+// no pulse is lost while the consumer is busy (up to the ring depth; the
+// overflow count says if it ever was).
+//
+// Sources (device):
+//   mcpwm - MCPWM capture channel latches the timer on the edge itself, so
+//           ISR latency drops out of the timestamp
+//   gpio  - fallback: GPIO interrupt, timestamp read in the ISR (old behaviour)
+//
+// SpscRing is portable (GCC atomics only) so it builds on a host.
+
+template <typename T, uint16_t N>
+class SpscRing {
+  static_assert((N & (N - 1)) == 0, "SpscRing size must be a power of two");
+public:
+  // Producer side (ISR).  false (and counted) when full.
+  bool push(const T& v) {
+    const uint32_t h = _head;
+    if (h - __atomic_load_n(&_tail, __ATOMIC_ACQUIRE) >= N) { ++_dropped; return false; }
+    _buf[h & (N - 1)] = v;
+    __atomic_store_n(&_head, h + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+  // Consumer side
+  bool pop(T& v) {
+    const uint32_t t = _tail;
+    if (t == __atomic_load_n(&_head, __ATOMIC_ACQUIRE)) return false;
+    v = _buf[t & (N - 1)];
+    __atomic_store_n(&_tail, t + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+  bool     empty()   const { return __atomic_load_n(&_tail, __ATOMIC_ACQUIRE) == __atomic_load_n(&_head, __ATOMIC_ACQUIRE); }
+  uint32_t dropped() const { return _dropped; }
+
+private:
+  T                 _buf[N];
+  volatile uint32_t _head = 0;
+  volatile uint32_t _tail = 0;
+  volatile uint32_t _dropped = 0;
+};
+
+struct HallEdge {
+  uint32_t ticks;   // capture timer value at the edge (== isrUs for gpio)
+  uint32_t isrUs;   // micros() when the ISR ran
+};
+
+#if defined(ESP_PLATFORM)
+#include <driver/mcpwm_cap.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+class HallCapture {
+public:
+  ~HallCapture() { end(); }
+
+  // edgeMode: 0=falling, 1=rising, 2=both.  *notify (if set) is woken on
+  // every edge.  Tries MCPWM capture first, then a GPIO interrupt.
+  bool begin(int pin, uint8_t edgeMode, TaskHandle_t* notify);
+  void end();
+
+  // Next edge on the micros() timeline, ISR latency removed where the
+  // hardware latched the edge.  Consumer only.
+  bool pop(uint32_t& us);
+  bool pending() const { return !_ring.empty(); }
+
+  const char* source()  const { return _source; }
+  uint32_t    dropped() const { return _ring.dropped(); }
+
+private:
+  bool startMcpwm(int pin, uint8_t edgeMode);
+  static bool onCapture(mcpwm_cap_channel_handle_t ch, const mcpwm_capture_event_data_t* ev, void* ctx);
+  static void onGpio(void* ctx);
+  void push(uint32_t ticks, uint32_t isrUs);
+
+  SpscRing<HallEdge, 64>     _ring;
+  TaskHandle_t*              _notify  = nullptr;
+  mcpwm_cap_timer_handle_t   _timer   = nullptr;
+  mcpwm_cap_channel_handle_t _chan    = nullptr;
+  int                        _gpioPin = -1;
+  uint32_t                   _tpu     = 1;       // capture ticks per microsecond
+  uint32_t                   _off     = 0;       // min(isrUs*tpu - ticks): clock offset + least latency
+  bool                       _haveOff = false;
+  const char*                _source  = "none";
+};
+#endif
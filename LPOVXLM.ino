@@ -15,7 +15,19 @@
 //   * All timing / strobe / Hall logic unchanged EXCEPT default strobe now OFF (see g_strobeEnable).
 //   * Per-arm drawing routes pixels into lane segments with per-arm reverse support.
 //   * If you need different two reused ports, change LANE_CLK[] / LANE_DATA[] below.
-//   * OUT_SPI remains the default. Parallel mode left available but not used in this wiring.
+//   * OUT_SPI remains the default. OUT_PARALLEL drives each arm from its own old 4-arm port
+//     (ARM_DATA[], shared clock on every ARM_CLK[]) through LCD_CAM i80 DMA (ParallelOutput).
+//   * Lanes are driven by SPI2/SPI3 with DMA from SK9822 wire buffers (LaneOutput); a lane
+//     falls back to bit-banged GPIO if its SPI host cannot be claimed.
+//   * Arm draws/blanks are committed once per render tick per lane; a lane whose only change is
+//     its outside-fed first arm is shifted partially (N LEDs + zero tail instead of 2N).
+//   * Render task (core 1) owns spoke scheduling + lane output; web/Wi-Fi/SD/frame loading run
+//     in the I/O task (core 0). Lane work requested by web handlers goes through g_renderQueue.
+//   * Hall edges are latched by MCPWM capture (GPIO interrupt fallback) into a lock-free ring
+//     (HallCapture) that the render task drains; debounce and pulses-per-rev counting live there.
+//   * /metrics: per-stage cycle-counter timings (SD, inflate, paint, show, blank ...) for scraping.
+//   * /bench times the live render path (spoke latency, paint, frame load histograms), optionally
+//     against a simulated rotor (RotationSim) so a standing rig can be measured.
 //
 // === Linkage fixes ===
 //  - g_brightness is now global (not static) so SD_Functions.cpp can link to it.
@@ -34,6 +46,9 @@
 #include <Update.h>
 #include <esp_system.h>
 #include <esp_task_wdt.h>
+#include <esp_heap_caps.h>
+#include <driver/gptimer.h>
+#include <esp_cpu.h>
 #include <stdlib.h>
 #include <string.h>
 #include <algorithm>  
@@ -44,6 +59,17 @@
 #include "HtmlUtils.h"
 #include "WifiManager.h"
 #include "SD_Functions.h"
+#include "LaneOutput.h"
+#include "SpokeKernels.h"
+#include "SpokeScheduler.h"
+#include "AngleEstimator.h"
+#include "HallCapture.h"
+#include "LatencyHist.h"
+#include "RotationSim.h"
+#include "FrameClock.h"
+#include "PolarFile.h"
+#include "FseqFormat.h"
+#include "PixelMap.h"
 
 
 // ---------- Optional zlib backends (auto-detect) ----------
@@ -56,9 +82,47 @@
   #endif
 #endif
 
+#if defined(MZ_OK) || defined(Z_OK)
+// Inflate one zlib stream into a buffer of exactly dstLen bytes
+static bool zlib_decompress(const uint8_t* src, size_t srcLen, uint8_t* dst, size_t dstLen) {
+#if defined(MZ_OK)
+  mz_ulong outLen = (mz_ulong)dstLen;
+  return mz_uncompress(dst, &outLen, src, (mz_ulong)srcLen) == MZ_OK && outLen == dstLen;
+#else
+  uLongf outLen = (uLongf)dstLen;
+  return uncompress(dst, &outLen, src, (uLong)srcLen) == Z_OK && outLen == dstLen;
+#endif
+}
+#endif
+
+// ---------- zstd backend ----------
+// Decompress-only zstd 1.5.7 is vendored as a single file (src/zstd/zstddeclib.c,
+// BSD licence), so compType 1 plays on every build; xLights exports zstd by default.
+#define ZSTD_STATIC_LINKING_ONLY   // ZSTD_initStaticDCtx / ZSTD_estimateDCtxSize
+#include "src/zstd/zstd.h"
+
+// One decoder context in a fixed workspace (PSRAM when present), allocated on the
+// first zstd open and kept.  One-shot decode writes straight into dst, so no
+// window buffer is needed beyond the workspace.
+static ZSTD_DCtx* s_zstdDctx = nullptr;
+static bool zstd_decompress(const uint8_t* src, size_t srcLen, uint8_t* dst, size_t dstLen) {
+  if (!s_zstdDctx) {
+    const size_t wsSize = ZSTD_estimateDCtxSize();
+    void* ws = psramFound() ? heap_caps_malloc(wsSize, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT) : nullptr;
+    if (!ws) ws = malloc(wsSize);
+    if (!ws) return false;
+    s_zstdDctx = ZSTD_initStaticDCtx(ws, wsSize);
+    if (!s_zstdDctx) { free(ws); return false; }
+  }
+  const size_t got = ZSTD_decompressDCtx(s_zstdDctx, dst, dstLen, src, srcLen);
+  return !ZSTD_isError(got) && got == dstLen;
+}
+
 // ---------- FreeRTOS mutex for SD serialization ----------
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
 
 // ---------- SK9822 / APA102 ----------
 
@@ -66,19 +130,9 @@
 enum OutputMode : uint8_t { OUT_SPI = 0, OUT_PARALLEL = 1 };
 uint8_t g_outputMode = OUT_SPI; // persisted in NVS (key: "outmode")
 
-// Parallel-GPIO driver state (kept for compatibility, not used in this wiring)
-#include "soc/gpio_struct.h"
-#include "driver/gpio.h"
-static uint32_t g_clkMask1 = 0;
-static uint32_t g_dataMask1[MAX_ARMS] = {0};
-static uint32_t g_allDataMask1 = 0;
-static bool     g_parallelPinsInit = false;
-static volatile uint8_t g_clkPadNops = 0;
-static inline void clk_pad_delay() { for (uint8_t i=0;i<g_clkPadNops;i++) __asm__ __volatile__("nop"); }
-static inline uint32_t mask1_for_pin(int gpio) { return (gpio >= 32) ? (1u << (gpio - 32)) : 0u; }
-static void configureParallelPins();
-static void sk9822_tx_parallel_spoke(uint16_t spokeIdx);
-static void sk9822_tx_parallel_black();
+// Parallel mode: every arm on its own post (the old 4-arm pins), all clocked
+// together by the LCD_CAM i80 engine from bit-transposed arm streams.
+#include "ParallelOutput.h"
 
 // ---------- Hall effect + status pixel ----------
 static const int      PIN_HALL_SENSOR        = 5;   // A3144 on this pin (LOW when magnet present)
@@ -107,7 +161,7 @@ static const uint32_t    ARM_TEST_SWEEP_HOLD_MS = 300;
 static const uint8_t     PULSES_PER_REV      = 1;   // default; can override at runtime via /rpm
 volatile uint32_t        g_lastPeriodUs      = 0;   // last valid pulse period (us)
 volatile uint32_t        g_pulseCount        = 0;   // total pulses seen
-volatile uint32_t        g_lastPulseUsIsr    = 0;   // last pulse timestamp (us) in ISR
+volatile uint32_t        g_lastPulseUsIsr    = 0;   // last pulse timestamp (us), edge time when captured
 static uint32_t          g_rpmUi             = 0;   // filtered RPM for UI/status
 static uint32_t          g_lastRpmUpdateMs   = 0;
 
@@ -121,38 +175,51 @@ static uint32_t g_rpmLastCount   = 0;  // pulse count snapshot at last sample
 static uint64_t g_rpmAccumulatedUs   = 0;  // total us accumulated for current window
 static uint32_t g_rpmAccumulatedPulses = 0; // pulses accumulated for current window
 
-// --- Hall sync flags used by ISR and main loop ---
-static volatile bool     g_hallSyncPending     = false;
-static volatile uint32_t g_hallSyncTimestampUs = 0;
-
-static void IRAM_ATTR hallIsr() {
-  uint32_t now = micros();
-  uint32_t last = g_lastPulseUsIsr;
-  g_lastPulseUsIsr = now;
-  // crude debounce: ignore pulses < 1ms apart (spurious)
-  uint32_t dt = now - last;
-  if (dt > 1000) {
-    g_lastPeriodUs = dt;
-    g_pulseCount = g_pulseCount + 1;
-    uint32_t count = g_pulseCount;
-    uint8_t ppr = g_pulsesPerRev ? g_pulsesPerRev : 1;
-    if ((ppr > 0) && (count % ppr) == 0) {
-      g_hallSyncTimestampUs = now;
-      g_hallSyncPending = true;
-    }
-  }
-}
+// --- Hall edges: captured into a lock-free ring, drained by the render task ---
+static HallCapture       g_hall;
+static TaskHandle_t      g_renderTask          = nullptr;   // woken by a Hall edge / spoke timer
 
-// Allow runtime selection of ISR edge
+// (Re)start edge capture, e.g. after /rpm changes the edge
 static void attachHallInterrupt() {
-  detachInterrupt(digitalPinToInterrupt(PIN_HALL_SENSOR));
-  int mode = (g_hallEdgeMode == 1) ? RISING : (g_hallEdgeMode == 2 ? CHANGE : FALLING);
-  attachInterrupt(digitalPinToInterrupt(PIN_HALL_SENSOR), hallIsr, mode);
-}
+  g_hall.begin(PIN_HALL_SENSOR, g_hallEdgeMode, &g_renderTask);
+  Serial.printf("[HALL] capture: %s\n", g_hall.source());
+}
+
+/* -------------------- Pipeline metrics (/metrics) -------------------- */
+// CPU cycle counts per playback stage, one CycleHist each (32 buckets, so
+// lock waits and slow reads of many milliseconds keep real percentiles).
+// Every stage is timed on one core (the counter is per core; render and I/O
+// tasks are pinned) and the SD stages run under the SD lock, so there is no extra
+// lock; a scrape may see one sample half-added.  Two counter reads and a
+// bucket increment per sample: left on in production.
+enum MetricStage : uint8_t {
+  MS_SD_LOCK = 0,   // waiting for the SD mutex (I/O core)
+  MS_SD_READ,       // raw frame / compressed block read
+  MS_INFLATE,       // block decompression
+  MS_FRAME_LOAD,    // whole loadFrame(), lock wait included
+  MS_HALL_SYNC,     // sync handling: estimator, base spokes, schedule (render core)
+  MS_PAINT,         // one arm drawn into its output words
+  MS_SHOW,          // commitOutputs(): transfers queued
+  MS_BLANK,         // one arm blanked
+  MS_COUNT
+};
+static const char* const METRIC_STAGE_NAME[MS_COUNT] = {
+  "sd_lock", "sd_read", "inflate", "frame_load", "hall_sync", "paint", "show", "blank"
+};
+static CycleHist g_stageCycles[MS_COUNT];
 
-// ===== PAST 4-ARM PINS (kept for reference; not used directly now) =====
-// static const int ARM_CLK[MAX_ARMS]  = { 47, 42, 38, 35 };
-// static const int ARM_DATA[MAX_ARMS] = { 45, 41, 39, 36 };
+struct StageTimer {
+  uint8_t  stage;
+  uint32_t t0;
+  explicit StageTimer(uint8_t s) : stage(s), t0((uint32_t)esp_cpu_get_cycle_count()) {}
+  ~StageTimer() { g_stageCycles[stage].add((uint32_t)esp_cpu_get_cycle_count() - t0); }
+};
+
+// ===== 4-ARM PINS (parallel mode: one data line per arm, shared clock) =====
+static const int ARM_CLK[MAX_ARMS]  = { 47, 42, 38, 35 };
+static const int ARM_DATA[MAX_ARMS] = { 45, 41, 39, 36 };
+static const uint32_t PAR_PCLK_HZ   = 10000000;
+static ParallelOutput* g_par = nullptr;   // non-null only in parallel mode
 
 // ===== NEW: TWO-LANE (TWO-POST) SPI =====
 static const uint8_t NUM_LANES = 2;
@@ -164,8 +231,13 @@ Arm 2 to keep from drawing too much current accross the entire PCB*/
 static const int LANE_CLK[NUM_LANES]  = { 47, 35 }; // old Arm1 CLK, old Arm4 CLK
 static const int LANE_DATA[NUM_LANES] = { 45, 36 }; // old Arm1 DATA, old Arm4 DATA
 
-// Lane DotStar objects (each lane drives two arms chained)
-static Adafruit_DotStar* g_lanes[NUM_LANES] = { nullptr, nullptr };
+// One SPI host per lane, both DMA-driven
+static const spi_host_device_t LANE_SPI_HOST[NUM_LANES] = { SPI2_HOST, SPI3_HOST };
+static const int LANE_SPI_HZ = 10000000;
+
+// Lane outputs (each lane drives two arms chained)
+static LaneOutput* g_lanes[NUM_LANES] = { nullptr, nullptr };
+static const char* g_laneSinkName[NUM_LANES] = { "none", "none" };
 
 // Virtual "per-arm" routing description into lanes
 struct ArmRoute {
@@ -186,6 +258,24 @@ Adafruit_DotStar* strips[MAX_ARMS] = { nullptr };
 // Brightness (0..255 computed from percent)
 // was: static uint8_t g_brightness = 63;
 uint8_t g_brightness = 63;
+uint8_t g_gammaX10   = 10;   // output gamma x10 (10 = linear)
+
+// Brightness + gamma output stage.  The coarse part of the brightness goes to
+// the SK9822 5-bit global current field; the 256-entry LUT only carries the
+// remainder (<= 1) and gamma, so colour keeps its full 8-bit range at low
+// output.  Full brightness, linear gamma = identity LUT + 0xFF header.
+static void computeLevels(uint8_t br, uint8_t gammaX10, uint8_t* lvl, uint8_t& hdr) {
+  const uint8_t g5 = (uint8_t)(((uint16_t)br * 31 + 254) / 255);   // ceil, so remainder <= 1
+  hdr = 0xE0 | g5;
+  if (!g5) { memset(lvl, 0, 256); return; }
+  const float resid = ((float)br / 255.0f) * (31.0f / (float)g5);
+  const float gamma = (float)gammaX10 / 10.0f;
+  for (uint16_t v = 0; v < 256; ++v) {
+    float x = (float)v / 255.0f;
+    if (gammaX10 != 10) x = powf(x, gamma);
+    lvl[v] = (uint8_t)lroundf(x * resid * 255.0f);
+  }
+}
 
 // Helpers for per-arm pixel routing into lanes
 static inline uint16_t armPixelCount() { return (g_pixelsPerArm ? g_pixelsPerArm : DEFAULT_PIXELS_PER_ARM); }
@@ -199,23 +289,67 @@ static inline uint16_t laneIndexForArmPixel(uint8_t arm, uint16_t pixel) {
 
 static inline void armSetPixel(uint8_t arm, uint16_t pixel, uint8_t R, uint8_t G, uint8_t B) {
   const ArmRoute &r = g_armRoute[arm];
-  if (r.lane >= NUM_LANES || !g_lanes[r.lane]) return;
   uint16_t idx = laneIndexForArmPixel(arm, pixel);
+  if (g_par) { g_par->setPixelColor(r.lane, idx, R, G, B); return; }
+  if (r.lane >= NUM_LANES || !g_lanes[r.lane]) return;
   g_lanes[r.lane]->setPixelColor(idx, R, G, B);
 }
 
+// Output words (hdr,B,G,R) for an arm's n LEDs: its lane segment, or its
+// parallel line.  nullptr if the arm has no output.
+static inline uint8_t* armWords(uint8_t arm, uint16_t n) {
+  const ArmRoute &r = g_armRoute[arm];
+  if (g_par) return (n <= g_par->numPixels()) ? g_par->words(r.lane) : nullptr;
+  return (r.lane < NUM_LANES && g_lanes[r.lane]) ? g_lanes[r.lane]->wordsAt(r.offset, n) : nullptr;
+}
+
+// Per-tick output commit.  armShow() only records which part of a lane
+// changed; commitOutputs() sends every touched lane once per render tick, so
+// both arms of a lane go out in one transfer.  A lane whose only change is
+// its outside-fed first arm is shifted partially: N LEDs + tail, not 2N.
+static uint16_t g_laneDirtyLeds[NUM_LANES] = { 0, 0 };  // LEDs to send from the lane input (0 = clean)
+static bool     g_parDirty = false;
+static uint32_t g_laneTxShows[NUM_LANES]   = { 0, 0 };
+static uint32_t g_laneTxPartial[NUM_LANES] = { 0, 0 };
+static uint64_t g_laneTxBytes[NUM_LANES]   = { 0, 0 };
+
 static inline void armShow(uint8_t arm) {
+  if (g_par) { g_parDirty = true; return; }
   const ArmRoute &r = g_armRoute[arm];
-  if (r.lane < NUM_LANES && g_lanes[r.lane]) g_lanes[r.lane]->show();
+  if (r.lane >= NUM_LANES) return;
+  const uint16_t end = r.offset + armPixelCount();
+  if (end > g_laneDirtyLeds[r.lane]) g_laneDirtyLeds[r.lane] = end;
 }
 
+static void commitOutputs() {
+  StageTimer st(MS_SHOW);
+  if (g_par) {
+    if (g_parDirty) g_par->show();
+    g_parDirty = false;
+    return;
+  }
+  for (uint8_t l=0; l<NUM_LANES; ++l) {
+    const uint16_t n = g_laneDirtyLeds[l];
+    if (!n) continue;
+    g_laneDirtyLeds[l] = 0;
+    if (!g_lanes[l]) continue;
+    g_laneTxBytes[l] += g_lanes[l]->show(n);
+    ++g_laneTxShows[l];
+    if (n < g_lanes[l]->numPixels()) ++g_laneTxPartial[l];
+  }
+}
+
+// Send every lane now (diagnostics, brightness, blackout paths)
 static inline void lanesShowAll() {
-  for (uint8_t l=0; l<NUM_LANES; ++l) if (g_lanes[l]) g_lanes[l]->show();
+  if (g_par) g_parDirty = true;
+  else for (uint8_t l=0; l<NUM_LANES; ++l) g_laneDirtyLeds[l] = 0xFFFF;
+  commitOutputs();
 }
 
 static inline void armClear(uint8_t arm) {
   const uint16_t n = armPixelCount();
-  for (uint16_t i=0;i<n;++i) armSetPixel(arm, i, 0,0,0);
+  uint8_t* p = armWords(arm, n);
+  if (p) for (uint16_t i=0;i<n;++i,p+=4) { p[1] = p[2] = p[3] = 0; }
   armShow(arm);
 }
 
@@ -225,12 +359,8 @@ static inline void armFillColor(uint8_t arm, uint8_t R, uint8_t G, uint8_t B) {
 }
 
 static inline void lanesClearAll() {
-  for (uint8_t l=0; l<NUM_LANES; ++l) {
-    if (!g_lanes[l]) continue;
-    uint16_t total = armPixelCount()*2; // two arms per lane
-    for (uint16_t i=0;i<total;++i) g_lanes[l]->setPixelColor(i,0,0,0);
-    g_lanes[l]->show();
-  }
+  for (uint8_t a=0; a<MAX_ARMS; ++a) armClear(a);
+  lanesShowAll();
 }
 
 // ---------- Watchdog ----------
@@ -238,13 +368,73 @@ static const uint32_t WATCHDOG_TIMEOUT_SECONDS = 8;
 bool     g_watchdogEnabled   = false;
 static bool g_watchdogAttached = false;
 
+// ---------- Render / I/O task split ----------
+// Core 1 runs only spoke scheduling + lane output (render task).
+// Core 0 runs web, Wi-Fi, SD and frame loading (I/O task) next to the Wi-Fi stack.
+static const BaseType_t  RENDER_CORE       = 1;
+static const BaseType_t  IO_CORE           = 0;
+static const UBaseType_t RENDER_TASK_PRIO  = 10;
+static const UBaseType_t IO_TASK_PRIO      = 1;
+static const uint32_t    RENDER_STACK      = 4096;
+static const uint32_t    IO_STACK          = 8192;
+static const uint32_t    RENDER_IDLE_SLACK_US = 1500; // sleep a tick when the next event is further out
+static TaskHandle_t      g_ioTask          = nullptr;
+
+// Commands posted from the I/O core to the render core.  Anything that touches
+// the lanes (or buffers the render core reads) goes through this queue.
+enum RenderCmdType : uint8_t {
+  RCMD_BLACKOUT = 0,   // blank every arm + reset spoke scheduler
+  RCMD_REBUILD,        // re-create lanes / arm routes after /mapcfg
+  RCMD_BRIGHTNESS,     // push g_brightness / g_gammaX10 to the lanes
+  RCMD_LANEDIAG,       // paint the per-arm lane identification colours
+  RCMD_SYNC,           // acknowledge via g_renderAck (render core is idle between spokes)
+  RCMD_PIXLUT,         // install ptr as the pixel offset table (frees the old one)
+  RCMD_RING_FLUSH,     // drop queued frames (seek); the frame on screen stays up
+  RCMD_BENCH,          // start a bench run; ptr = BenchRequest* (freed by the render core)
+  RCMD_BENCH_STOP,     // end the bench run / rotor simulation
+};
+struct RenderCmd { uint8_t type; void* ptr; };
+static QueueHandle_t     g_renderQueue     = nullptr;
+static SemaphoreHandle_t g_renderAck       = nullptr;
+static const UBaseType_t RENDER_QUEUE_LEN  = 16;
+
+static bool renderPost(uint8_t type, void* ptr = nullptr) {
+  if (!g_renderQueue) return false;
+  RenderCmd cmd = { type, ptr };
+  if (xQueueSend(g_renderQueue, &cmd, pdMS_TO_TICKS(50)) != pdTRUE) {
+    Serial.printf("[RENDER] queue full, dropped cmd %u\n", (unsigned)type);
+    return false;
+  }
+  return true;
+}
+
+// Block the caller until the render core has drained its queue.  After this
+// returns true the render core is not inside a paint.  false on timeout: the
+// render core may still be using shared buffers (see renderSyncWait()).
+static bool renderSync(uint32_t timeoutMs = 500) {
+  if (!g_renderTask || xTaskGetCurrentTaskHandle() == g_renderTask) return true;
+  while (xSemaphoreTake(g_renderAck, 0) == pdTRUE) {}   // late ack of a sync that timed out
+  if (!renderPost(RCMD_SYNC)) return false;
+  return xSemaphoreTake(g_renderAck, pdMS_TO_TICKS(timeoutMs)) == pdTRUE;
+}
+
+// renderSync() that does not give up; required before shared buffers are freed
+static void renderSyncWait() {
+  while (!renderSync()) {
+    Serial.println("[RENDER] sync timed out, waiting");
+    feedWatchdog();
+  }
+}
+
 static void applyWatchdogSetting() {
-  const uint32_t ALL_CORES_MASK = (1U << portNUM_PROCESSORS) - 1U;
+  // The render core busy-waits between spokes, so only core 0's idle task is watched;
+  // the render and I/O tasks are subscribed explicitly instead.
+  const uint32_t IDLE_CORE_MASK = (1U << IO_CORE);
 
   if (g_watchdogEnabled) {
     esp_task_wdt_config_t cfg = {
       .timeout_ms    = WATCHDOG_TIMEOUT_SECONDS * 1000U,
-      .idle_core_mask= ALL_CORES_MASK,
+      .idle_core_mask= IDLE_CORE_MASK,
       .trigger_panic = true
     };
     esp_err_t err = esp_task_wdt_init(&cfg);
@@ -254,17 +444,22 @@ static void applyWatchdogSetting() {
       return;
     }
     if (!g_watchdogAttached) {
-      err = esp_task_wdt_add(nullptr);
-      if (err == ESP_OK || err == ESP_ERR_INVALID_STATE) {
+      TaskHandle_t tasks[2] = { g_renderTask, g_ioTask };
+      bool any = false;
+      for (TaskHandle_t t : tasks) {
+        if (!t) continue;
+        err = esp_task_wdt_add(t);
+        if (err == ESP_OK || err == ESP_ERR_INVALID_STATE) any = true;
+        else Serial.printf("[WDT] add failed: %d\n", (int)err);
+      }
+      if (any) {
         g_watchdogAttached = true;
-        esp_task_wdt_reset();
         Serial.printf("[WDT] Enabled (timeout %us)\n", (unsigned)WATCHDOG_TIMEOUT_SECONDS);
-      } else {
-        Serial.printf("[WDT] add failed: %d\n", (int)err);
       }
     }
   } else if (g_watchdogAttached) {
-    esp_task_wdt_delete(nullptr);
+    if (g_renderTask) esp_task_wdt_delete(g_renderTask);
+    if (g_ioTask)     esp_task_wdt_delete(g_ioTask);
     esp_task_wdt_deinit();
     g_watchdogAttached = false;
     Serial.println("[WDT] Disabled");
@@ -273,7 +468,7 @@ static void applyWatchdogSetting() {
 // was: static inline void feedWatchdog() { ... }
 void feedWatchdog() { if (g_watchdogAttached) esp_task_wdt_reset(); }
 
-// Persistent scratch for zlib frames
+// Persistent scratch for compressed blocks
 static uint8_t* s_ctmp = nullptr;
 static size_t   s_ctmp_size = 0;
 
@@ -300,8 +495,8 @@ uint32_t      g_staConnectStartMs   = 0;
 // ---------- Persisted settings (NVS = flash) ----------
 Preferences prefs;
 uint8_t  g_brightnessPercent = 25;
-uint16_t g_fps               = 40;
-uint32_t g_framePeriodMs     = 25;
+uint16_t g_fps               = 40;     // override rate (/speed?fps=)
+bool     g_fpsFromFile       = true;   // follow the FSEQ step time; false: g_fps
 bool     g_autoplayEnabled   = true;
 bool     g_bgEffectEnabled   = false;
 bool     g_bgEffectActive    = false;
@@ -328,35 +523,70 @@ volatile uint16_t g_indexPosition = 0;
 // Playback state
 volatile bool  g_playing = false, g_paused = false;
 String         g_currentPath;
-uint32_t       g_frameIndex = 0, g_lastTickMs = 0;
+uint32_t       g_frameIndex = 0;
 uint32_t       g_bootMs = 0;
 const uint32_t SELECT_TIMEOUT_MS = 5UL * 60UL * 1000UL;
 
-// Arm runtime (timers/blanking)
+// Arm runtime (spoke bases); spoke starts + lit/blank timing live in g_sched
 struct ArmRuntimeState {
   uint16_t baseSpoke = 0;
   uint16_t currentSpoke = 0;
-  uint32_t blankDeadlineUs = 0;
-  bool     lit = false;
 };
 static ArmRuntimeState g_armState[MAX_ARMS];
-static uint32_t        g_spokeDurationUs     = 0;
-static uint32_t        g_nextSpokeDeadlineUs = 0;
-static uint16_t        g_spokeStep           = 0;
+static SpokeScheduler  g_sched;
+static AngleEstimator  g_angle;                    // sync time / period / acceleration tracker
+static uint32_t        g_hallSyncRejected    = 0;  // outlier syncs ignored by g_angle
+static uint32_t        g_schedWakeups        = 0;  // spoke timer sleeps
+static uint32_t        g_schedLateUsLast     = 0;  // commit start minus deadline
+static uint32_t        g_schedLateUsMax      = 0;
+static gptimer_handle_t g_spokeTimer = nullptr;             // null: spokes are polled
+
+// Hall sync trace (raw sync timestamps) for offline estimator tuning: written
+// by the render core while g_hallTraceOn, saved/replayed by /hall/trace + /hall/replay
+static const uint32_t  HALL_TRACE_MAX        = 8192;
+static uint32_t*       g_hallTrace           = nullptr;
+static volatile uint32_t g_hallTraceLen      = 0;
+static volatile bool   g_hallTraceOn         = false;
+static uint32_t        g_spokeDurationUs     = 0;  // predicted spoke period (g_angle at Hall sync)
+
+// Bench (/bench): latency histograms of the live render path, optionally fed
+// by a simulated rotor (g_sim) so it runs on a rig that is not spinning.
+// Written by the render core (frame loads: I/O core), read by /bench.
+static RotationSim       g_sim;
+static uint32_t*         g_simTrace          = nullptr;  // recorded syncs played by g_sim (owned)
+static volatile bool     g_benchOn           = false;
+struct BenchRequest {
+  bool           simulate = false;   // drive the schedule from g_sim instead of the Hall sensor
+  RotationSimCfg sim;                // sim.trace (if any) is handed over with the request
+  uint32_t       seconds  = 0;       // 0 = until stopped
+};
+static uint32_t          g_benchStartMs      = 0;
+static uint32_t          g_benchEndMs        = 0;
+static uint32_t          g_benchUntilMs      = 0;        // 0 = until stopped
+static LatencyHist       g_benchSpokeUs;                 // spoke start -> lanes committed
+static LatencyHist       g_benchPaintUs;                 // drawing one spoke on every arm
+static LatencyHist       g_benchLoadUs;                  // frame load (read + decode)
+static uint32_t          g_benchMissed       = 0;        // spokes committed after the next one was due
+static uint32_t          g_benchSkipBase     = 0;        // g_sched.skipped() at start
+static uint32_t          g_benchSpokeStartUs = 0;
+static bool              g_benchSpokeOpen    = false;    // a spoke fired, its commit not yet timed
 static const uint32_t  ARM_BLANK_DELAY_US    = 80; // microseconds each spoke stays lit
 static bool            g_frameValid          = false;
 
-static inline bool microsReached(uint32_t now, uint32_t target) {
-  return (int32_t)(now - target) >= 0;
-}
-
 static void resetArmRuntimeStates();
 static void blankArm(uint8_t arm);
 static void paintArmAt(uint8_t arm, uint16_t spokeIdx, uint32_t nowUs);
 static void processArmBlanking(uint32_t nowUs);
-static void processHallSyncEvent(uint32_t nowUs);
+static void processHallSyncEvent(uint32_t syncUs, uint32_t nowUs, bool schedule);
+static void drainHallEdges(uint32_t nowUs, bool schedule);
+static void benchStart(BenchRequest* rq);
+static void benchStop();
 static void advancePredictedSpokes(uint32_t nowUs);
-static bool loadNextFrame();
+static void swapToClockFrame();
+static void swapAtBoundary(uint16_t step);
+static bool advanceFrameRing();
+struct PixelLut;
+static void installPixelLut(PixelLut* lut);
 
 /* -------------------- Strobe gating / angular timing -------------------- */
 static const int PIN_STROBE_GATE = -1; // -1 to disable gate pin
@@ -524,79 +754,415 @@ static void handleMapCfg();
 static void handleWifiCfg();
 static void handleFseqHeader();
 static void handleCBlocks();
+static void handleSeek();        // /seek?frame=N | ?ms=T
 static void handleAutoplay();
 static void handleWatchdog();
 static void handleBgEffect();
 static void handleStrobe();
+static void handleGamma();       // /gamma?value=2.2
 static void handleArmPhase();
 static void handleRpmCfg();
+static void handleFrameSwap();   // /frameswap?align=1&spoke=0&timeoutMs=250
+static void handleSeqCache();    // /seqcache?budgetKB=2048
+static void handleTranscode();   // /transcode (GET status, POST action=start|cancel, auto=0|1)
+static String seqCacheJson();
+static String transcodeJson();
 static void handleReboot();
 static void handleOutMode(); // declared here; implemented later with setOutputMode()
 static void handleDiagMap();     // /diag/map?arm=1&pix=0&spoke=0
 static void handleFseqRanges();  // /fseq/ranges
 static void handleLaneDiag();    // /lanediag
+static void handleBenchKernels(); // /bench/kernels
+static void handleHallTrace();   // /hall/trace?action=start|stop|save&path=/hall.bin
+static void handleHallReplay();  // /hall/replay?path=/hall.bin&spokes=40
+static void handleMetrics();     // /metrics (Prometheus text: per-stage timings + counters)
+static void handleBench();       // /bench (GET results, POST action=start|stop, rpm=, path=, seconds=)
 
 
 static bool otaAuthOK() { return true; } // stub (shared with SD module)
 
 /* -------------------- FSEQ v2 reader -------------------- */
-struct SparseRange { uint32_t start, count, accum; };
-struct CompBlock    { uint32_t uSize, cSize; };
-
-struct FseqHeader {
-  uint16_t chanDataOffset = 0;
-  uint8_t  minor = 0, major = 2;
-  uint16_t varDataOffset = 0;
-  uint32_t channelCount = 0;
-  uint32_t frameCount   = 0;
-  uint8_t  stepTimeMs   = 25;
-  uint8_t  flags        = 0;
-  uint8_t  compType     = 0;     // 0=none, 1=zstd, 2=zlib
-  uint8_t  compBlockCnt = 0;
-  uint8_t  sparseCnt    = 0;
-  uint64_t uniqueId     = 0;
-};
-
+// Container decoding and indexing live in FseqFormat.h (also built on the host)
 File         g_fseq;
 FseqHeader   g_fh;
 SparseRange* g_ranges      = nullptr;
-uint8_t*     g_frameBuf    = nullptr;
+uint8_t*     g_frameBuf    = nullptr;   // ring slot currently shown by the render core (not owned)
 CompBlock*   g_cblocks     = nullptr;
 uint32_t     g_compCount   = 0;
+uint64_t*    g_compOffs    = nullptr;   // prefix sums: file offset of block i (g_compCount+1 entries)
 uint64_t     g_compBase    = 0;
 bool         g_compPerFrame= false;
+uint32_t*    g_blockFirst  = nullptr;   // first frame of block i (g_compCount+1 entries, last = frameCount)
+uint32_t     g_blockFrames = 0;         // frames in the largest block
+
+// Decoded multi-frame blocks.  Sequential play hits the newest slot; the slot
+// holding block 0 is kept while others are free to evict, so a loop restarts
+// without inflating again, and short seeks back land in recently used blocks.
+static const uint8_t BLOCK_CACHE_SLOTS  = 4;
+static const size_t  BLOCK_CACHE_BUDGET = 2 * 1024 * 1024;  // total decoded bytes (PSRAM)
+struct BlockSlot { uint8_t* buf; uint32_t block; uint32_t lastUse; };
+static BlockSlot g_blockCache[BLOCK_CACHE_SLOTS] = {};
+static uint8_t   g_blockCacheSlots = 0;
+static uint32_t  g_blockUseTick    = 0;
+static uint32_t  g_blockHits       = 0;
+static uint32_t  g_blockMisses     = 0;
+
+// Raw read-ahead.  Uncompressed files are read in one SD request per window of
+// consecutive frames (RAW_RA_FRAMES, capped by RAW_RA_BUDGET) into a PSRAM
+// buffer whose file offset starts on a sector; loadFrame() then copies frames
+// out of memory and only goes back to the card when it leaves the window.
+static const uint32_t RAW_RA_FRAMES = 16;
+static const size_t   RAW_RA_BUDGET = 256 * 1024;
+static const size_t   RAW_RA_ALIGN  = 512;         // SD sector
+static uint8_t*  g_raBuf       = nullptr;
+static size_t    g_raCap       = 0;                // allocated bytes
+static uint64_t  g_raOff       = 0;                // file offset of g_raBuf[0]
+static size_t    g_raLen       = 0;                // valid bytes (0 = empty)
+static uint32_t  g_raFills     = 0;
+static uint32_t  g_raHits      = 0;
+static uint64_t  g_raBytes     = 0;
+static uint32_t  g_raFillUsLast = 0;
+static uint64_t  g_raFillUsSum  = 0;
+
+// Sequence residency cache.  Short loops (BG effects) and anything else that
+// fits g_seqBudgetKB keep every decoded frame in PSRAM, keyed by path +
+// uniqueId (+ size, so a re-export never matches).  Frames are stored as the
+// producer loads them; once a loop has played, the sequence runs with no SD
+// reads at all and switching back to it does not refill anything.  Entries
+// not on air are evicted least recently used.  uniqueId is often 0 outside
+// xLights, so SD_Functions forgets a path whenever it is rewritten, renamed or
+// deleted.  I/O core only (open, and the producer, which openFseq parks).
+static const uint8_t SEQ_CACHE_MAX = 4;
+struct SeqCacheEntry {
+  String   path;
+  uint64_t uniqueId;
+  uint32_t frames, chans;
+  uint8_t* data;        // frames * chans
+  uint8_t* have;        // one bit per frame
+  uint32_t loaded;      // frames present
+  uint32_t lastUse;
+  bool     stale;       // file changed on the card; dropped at the next open
+};
+static SeqCacheEntry  g_seqCache[SEQ_CACHE_MAX] = {};
+static SeqCacheEntry* g_seqCur       = nullptr;   // entry of the open sequence (null: not cached)
+static uint16_t       g_seqBudgetKB  = 2048;
+static uint32_t       g_seqUseTick   = 0;
+static uint32_t       g_seqHits      = 0;
+static uint32_t       g_seqStores    = 0;
+static uint32_t       g_seqEvictions = 0;
+
+// Load/decode timing (producer side).  Block decode time is spread over the
+// frames served from it, so avg decode is comparable across raw/zlib/zstd.
+static uint32_t g_loadUsLast   = 0;
+static uint32_t g_decodeUsLast = 0;
+static uint64_t g_loadUsSum    = 0;
+static uint64_t g_decodeUsSum  = 0;
+static uint32_t g_loadCount    = 0;
+
+// Sparse range lookup (fseqIndexSparse): start-sorted copy for bisection
+static SparseRange*  g_rangesSorted = nullptr;
+static uint8_t       g_sparseMode   = XLATE_DENSE;
+
+/* -------------------- Frame prefetch ring -------------------- */
+// A producer task on the I/O core reads + inflates frames N+1..N+k into a fixed
+// ring; the render core only advances g_ringTail.  Single producer / single
+// consumer: head and tail are free-running counters, slot = counter % depth.
+// The slot at tail-1 is the one on screen, so the producer keeps one slot clear of it.
+static const uint8_t     FRAME_RING_DEPTH  = 4;
+static const uint8_t     FRAME_RING_MIN    = 2;
+static const UBaseType_t PREFETCH_TASK_PRIO = 2;   // above the I/O task, below Wi-Fi
+static const uint32_t    PREFETCH_STACK     = 4096;
+static uint8_t*          g_ringBuf[FRAME_RING_DEPTH]   = { nullptr };
+static uint32_t          g_ringFrame[FRAME_RING_DEPTH] = { 0 };  // frame index held by each slot
+static uint8_t           g_ringDepth       = 0;
+static volatile uint32_t g_ringHead        = 0;   // produced (written by prefetch task)
+static volatile uint32_t g_ringTail        = 0;   // taken    (written by render task)
+static uint32_t          g_prefetchNext    = 0;   // next frame index to load
+static volatile bool     g_prefetchRun     = false;
+static volatile bool     g_prefetchFailed  = false;  // read/inflate error; I/O task runs recovery
+static volatile bool     g_ringStarved     = false;
+static uint32_t          g_ringHighWater   = 0;
+static uint32_t          g_ringUnderruns   = 0;
+static FrameClock        g_frameClock;                    // render core
+static uint32_t          g_clockFrame      = 0;           // frame the clock has reached
+static volatile uint32_t g_frameWanted     = UINT32_MAX;  // g_clockFrame for the producer (UINT32_MAX: none)
+static volatile bool     g_clockRestart    = true;        // restart on the next frame that lands
+static uint32_t          g_framesDropped   = 0;           // frames skipped to stay on the timeline
+
+// Frame swaps wait for a revolution boundary (Hall sync, or spoke step
+// g_swapStep) so one revolution never shows two frames; g_swapTimeoutMs
+// forces the swap when the rotor is stopped or slow.
+static bool              g_swapAlign       = true;
+static uint16_t          g_swapStep        = 0;           // 0 = at the Hall sync
+static uint16_t          g_swapTimeoutMs   = 250;
+static bool              g_swapPending     = false;       // render core
+static uint32_t          g_swapPendingUs   = 0;
+static uint32_t          g_swapsDeferred   = 0;           // swaps that waited for a boundary
+static uint32_t          g_swapsAligned    = 0;           // ... and made it
+static uint32_t          g_swapsForced     = 0;           // ... and timed out
+static uint32_t          g_swapsImmediate  = 0;           // alignment off / rotor not scheduled
+static SemaphoreHandle_t g_pipeMutex       = nullptr; // held by the producer around each load
+
+// Pre-encoded SK9822 words for a ring slot, one lane-ordered run of pixels*4
+// bytes (hdr,B,G,R) per (arm, slice) with arm reversal applied, so a spoke
+// paint is a copy into the lane buffer.  Encoded by the producer; a slot whose
+// gen != g_encGen (brightness, gamma or mapping changed since) is painted the slow way.
+struct SpokeWire { uint32_t gen; uint8_t arms; uint16_t slices; uint16_t pixels; size_t cap; uint8_t* words; };
+static SpokeWire         g_ringWire[FRAME_RING_DEPTH] = {};
+static const SpokeWire*  g_frameWire       = nullptr;  // slot on screen (render core)
+static volatile uint32_t g_encGen          = 1;        // 0 never matches
+static PixelLut*         g_encLut          = nullptr;  // LUT the producer encodes with (render core frees it)
+static const size_t      SPOKE_WIRE_MAX_INTERNAL = 64 * 1024;  // without PSRAM, skip bigger encodings
+static uint32_t          g_paintWire       = 0;
+static uint32_t          g_paintGeneric    = 0;
+static uint32_t          g_paintNative     = 0;
+static TaskHandle_t      g_prefetchTask    = nullptr;
+
+// Spinner-native sequence (PolarFile.h).  When the open .fseq has a complete
+// twin built for the current mapping, g_fseq is the twin and every frame is
+// ready-to-send lane words; g_fh keeps the source's timing and identity.
+static bool              g_nativeSeq       = false;
+static PolarHeader       g_povHdr;                     // twin in use (g_nativeSeq)
+static uint32_t          g_mapHash         = 0;        // mapping the offset table was built for
+static volatile bool     g_povReopen       = false;    // I/O core: reopen g_currentPath (twin finished / stale)
+static bool              g_povAuto         = true;     // transcode every sequence that has no twin
+
+// Background transcode of the open sequence.  Started on the I/O core with the
+// producer parked, stepped by the producer when the ring is full, so it only
+// uses SD time playback does not need.  It reads through its own handle and
+// buffers: the read-ahead window, block cache and load stats stay playback's.
+struct PolarJob {
+  bool     active = false;
+  File     file;
+  File     in;                     // own handle on the source sequence
+  String   path;
+  PolarHeader hdr;
+  uint32_t next = 0;               // next source frame
+  uint8_t* src  = nullptr;         // one decoded source frame
+  uint8_t* out  = nullptr;         // one native frame
+  uint8_t* cbuf = nullptr;         // compressed block being read (largest block)
+  uint8_t* blk  = nullptr;         // decoded multi-frame block
+  uint32_t blkIdx = UINT32_MAX;    // block held in blk
+  uint32_t inPos  = 0;             // bytes of the current source frame / block read
+  uint32_t outPos = 0;             // bytes of out written
+  bool     outReady = false;       // out holds frame `next`
+  uint64_t readBytes = 0;
+  uint32_t startMs = 0;
+  uint64_t triedId = 0;            // (uniqueId, mapHash) started since the open, so it runs once
+  uint32_t triedHash = 0;
+  uint32_t done = 0, aborted = 0;
+  uint32_t lastMs = 0;             // duration of the last completed job
+  const char* lastError = "";
+};
+static PolarJob          g_pov;
+static const uint32_t    POLAR_STEP_BYTES  = 32 * 1024; // SD bytes (read + written) per producer step
+static const uint32_t    POLAR_STEP_US     = 4000;     // and time per step
+
+static inline uint32_t ringFill() {
+  return __atomic_load_n(&g_ringHead, __ATOMIC_ACQUIRE) - __atomic_load_n(&g_ringTail, __ATOMIC_ACQUIRE);
+}
+
+// Large frame buffers prefer PSRAM; fall back to the default heap
+static uint8_t* allocFrameMem(size_t bytes) {
+  uint8_t* p = psramFound() ? (uint8_t*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT) : nullptr;
+  return p ? p : (uint8_t*)malloc(bytes);
+}
 
 /* -------------------- Small helpers -------------------- */
 static inline int32_t  clampI32(int32_t v, int32_t lo, int32_t hi){ if(v<lo) return lo; if(v>hi) return hi; return v; }
 static inline uint8_t  activeArmCount(){ return (g_armCount < 1) ? 1 : ((g_armCount > MAX_ARMS) ? MAX_ARMS : g_armCount); }
 
-// --- Binary read helpers (little-endian) ---
-static inline bool readU16(File &f, uint16_t &out) {
-  uint8_t b[2]; if (f.read(b,2)!=2) return false;
-  out = (uint16_t)b[0] | ((uint16_t)b[1] << 8);
-  return true;
-}
-static inline bool readU32(File &f, uint32_t &out) {
-  uint8_t b[4]; if (f.read(b,4)!=4) return false;
-  out = (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
-  return true;
-}
-static inline bool readU64(File &f, uint64_t &out) {
-  uint8_t b[8]; if (f.read(b,8)!=8) return false;
-  out =  ((uint64_t)b[0])        | ((uint64_t)b[1] << 8)  | ((uint64_t)b[2] << 16) | ((uint64_t)b[3] << 24)
-       | ((uint64_t)b[4] << 32)  | ((uint64_t)b[5] << 40) | ((uint64_t)b[6] << 48) | ((uint64_t)b[7] << 56);
-  return true;
+
+/* -------------------- FSEQ open/close/load -------------------- */
+static void freeBlockCache(){
+  for (uint8_t i=0; i<BLOCK_CACHE_SLOTS; ++i) {
+    if (g_blockCache[i].buf) free(g_blockCache[i].buf);
+    g_blockCache[i] = { nullptr, UINT32_MAX, 0 };
+  }
+  g_blockCacheSlots = 0;
+  g_blockUseTick = 0; g_blockHits = 0; g_blockMisses = 0;
+}
+
+// At least one slot or fail; more only while they fit the budget
+static bool allocBlockCache(size_t bytes){
+  freeBlockCache();
+  const uint8_t want = psramFound() ? BLOCK_CACHE_SLOTS : 1;
+  for (uint8_t i=0; i<want; ++i) {
+    if (i && (size_t)(i + 1) * bytes > BLOCK_CACHE_BUDGET) break;
+    uint8_t* p = allocFrameMem(bytes);
+    if (!p) break;
+    g_blockCache[i] = { p, UINT32_MAX, 0 };
+    g_blockCacheSlots = i + 1;
+  }
+  return g_blockCacheSlots > 0;
+}
+
+static void freeRawReadAhead(){
+  if (g_raBuf) heap_caps_free(g_raBuf);
+  g_raBuf = nullptr; g_raCap = 0; g_raOff = 0; g_raLen = 0;
+  g_raFills = 0; g_raHits = 0; g_raBytes = 0; g_raFillUsLast = 0; g_raFillUsSum = 0;
+}
+
+// Window of RAW_RA_FRAMES frames (at least one frame + alignment slack).
+// Without PSRAM or on OOM, raw frames are read one by one as before.
+static void allocRawReadAhead(uint32_t frameBytes){
+  freeRawReadAhead();
+  size_t cap = psramFound() ? (size_t)frameBytes * RAW_RA_FRAMES : 0;
+  if (cap > RAW_RA_BUDGET) cap = RAW_RA_BUDGET;
+  if (cap < (size_t)frameBytes * 2 + RAW_RA_ALIGN) return;   // no gain over per-frame reads
+  cap = (cap + RAW_RA_ALIGN - 1) & ~(RAW_RA_ALIGN - 1);
+  g_raBuf = (uint8_t*)heap_caps_aligned_alloc(64, cap, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (g_raBuf) g_raCap = cap;
+}
+
+static void seqCacheDrop(uint8_t i){
+  SeqCacheEntry& e = g_seqCache[i];
+  if (e.data) heap_caps_free(e.data);
+  if (e.have) free(e.have);
+  if (g_seqCur == &e) g_seqCur = nullptr;
+  e = SeqCacheEntry();
+}
+
+static size_t seqCacheUsed(){
+  size_t used = 0;
+  for (uint8_t i=0; i<SEQ_CACHE_MAX; ++i)
+    if (g_seqCache[i].data) used += (size_t)g_seqCache[i].frames * g_seqCache[i].chans;
+  return used;
+}
+
+// Drop least recently used entries (never the one on air) until `need` more fits
+static void seqCacheMakeRoom(size_t need){
+  const size_t budget = (size_t)g_seqBudgetKB * 1024;
+  for (;;) {
+    int victim = -1;
+    uint8_t used = 0;
+    for (uint8_t i=0; i<SEQ_CACHE_MAX; ++i) {
+      const SeqCacheEntry& e = g_seqCache[i];
+      if (!e.data) continue;
+      ++used;
+      if (&e != g_seqCur && (victim < 0 || e.lastUse < g_seqCache[victim].lastUse)) victim = i;
+    }
+    if (seqCacheUsed() + need <= budget && used < SEQ_CACHE_MAX) return;
+    if (victim < 0) return;
+    seqCacheDrop((uint8_t)victim);
+    ++g_seqEvictions;
+  }
+}
+
+// openFseq: attach the sequence just parsed into g_fh to its cache entry,
+// creating one if it fits the budget.  g_seqCur stays null otherwise.
+static void seqCacheBind(const String& path){
+  g_seqCur = nullptr;
+  const size_t bytes = (size_t)g_fh.frameCount * g_fh.channelCount;
+  for (uint8_t i=0; i<SEQ_CACHE_MAX; ++i) {
+    SeqCacheEntry& e = g_seqCache[i];
+    if (!e.data) continue;
+    if (e.path == path && !e.stale && e.uniqueId == g_fh.uniqueId && e.frames == g_fh.frameCount && e.chans == g_fh.channelCount) {
+      e.lastUse = ++g_seqUseTick;
+      g_seqCur = &e;
+      return;
+    }
+    if (e.path == path) seqCacheDrop(i);   // same file, different contents
+  }
+  if (!psramFound() || !bytes || bytes > (size_t)g_seqBudgetKB * 1024) return;
+  seqCacheMakeRoom(bytes);
+  if (seqCacheUsed() + bytes > (size_t)g_seqBudgetKB * 1024) return;
+  SeqCacheEntry* slot = nullptr;
+  for (uint8_t i=0; i<SEQ_CACHE_MAX && !slot; ++i) if (!g_seqCache[i].data) slot = &g_seqCache[i];
+  if (!slot) return;
+  uint8_t* data = (uint8_t*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  uint8_t* have = (uint8_t*)calloc((g_fh.frameCount + 7) / 8, 1);
+  if (!data || !have) { if (data) heap_caps_free(data); free(have); return; }
+  slot->path = path; slot->uniqueId = g_fh.uniqueId;
+  slot->frames = g_fh.frameCount; slot->chans = g_fh.channelCount;
+  slot->data = data; slot->have = have; slot->loaded = 0;
+  slot->lastUse = ++g_seqUseTick;
+  g_seqCur = slot;
+}
+
+// SD_Functions: path was rewritten, renamed or deleted.  Its entries and its
+// twins' go now; the one on air keeps playing and is dropped at the next open.
+void seqCacheForget(const String& path){
+  const String twin = path + POLAR_SUFFIX + "#";
+  for (uint8_t i=0; i<SEQ_CACHE_MAX; ++i) {
+    SeqCacheEntry& e = g_seqCache[i];
+    if (!e.data || (e.path != path && !e.path.startsWith(twin))) continue;
+    if (&e == g_seqCur) e.stale = true;
+    else seqCacheDrop(i);
+  }
+}
+
+static inline bool seqCacheComplete(){ return g_seqCur && g_seqCur->loaded == g_seqCur->frames; }
+
+static inline bool seqCacheHas(uint32_t idx){
+  return g_seqCur && (g_seqCur->have[idx >> 3] >> (idx & 7)) & 1;
+}
+
+static void seqCacheStore(uint32_t idx, const uint8_t* src){
+  if (!g_seqCur || seqCacheHas(idx)) return;
+  memcpy(g_seqCur->data + (size_t)idx * g_seqCur->chans, src, g_seqCur->chans);
+  g_seqCur->have[idx >> 3] |= (uint8_t)(1u << (idx & 7));
+  ++g_seqCur->loaded;
+  ++g_seqStores;
+}
+
+// Park the producer between loads; returns with the pipe mutex released.
+// Waits as long as the load in progress takes (an SD retry can be slow):
+// callers go on to swap or free what the producer reads.
+static void stopPrefetch(){
+  g_prefetchRun = false;
+  if (!g_pipeMutex) return;
+  while (xSemaphoreTake(g_pipeMutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+    Serial.println("[PREFETCH] producer busy, waiting");
+    feedWatchdog();
+  }
+  xSemaphoreGive(g_pipeMutex);
 }
 
+static void freeFrameRing(){
+  for (uint8_t i=0; i<FRAME_RING_DEPTH; ++i) {
+    if (g_ringBuf[i]) { free(g_ringBuf[i]); g_ringBuf[i] = nullptr; }
+    if (g_ringWire[i].words) free(g_ringWire[i].words);
+    g_ringWire[i] = {};
+  }
+  g_frameWire = nullptr;
+  g_ringDepth = 0;
+  g_ringHead = 0; g_ringTail = 0;
+  g_prefetchNext = 0;
+  g_prefetchFailed = false;
+  g_ringStarved = false;
+  g_frameWanted = UINT32_MAX;
+  g_clockRestart = true;
+  g_frameBuf = nullptr;
+}
 
-/* -------------------- FSEQ open/close/load -------------------- */
 static void freeFseq(){
+  // Stop the producer and the render core from touching frame buffers before they go away
+  g_playing = false;
+  g_frameValid = false;
+  stopPrefetch();
+  renderSyncWait();
+  polarJobAbort("closed");
+  g_pov.triedId = 0; g_pov.triedHash = 0;   // the next open may try again
+
+  g_encLut = nullptr;
+  renderPost(RCMD_PIXLUT, nullptr);   // offsets belong to the old file
   if (g_fseq) g_fseq.close();
   if (g_ranges){ free(g_ranges); g_ranges=nullptr; }
-  if (g_frameBuf){ free(g_frameBuf); g_frameBuf=nullptr; }
+  if (g_rangesSorted){ free(g_rangesSorted); g_rangesSorted=nullptr; }
+  g_sparseMode = XLATE_DENSE;
+  freeFrameRing();
   if (g_cblocks){ free(g_cblocks); g_cblocks=nullptr; }
+  if (g_compOffs){ free(g_compOffs); g_compOffs=nullptr; }
   if (s_ctmp){ free(s_ctmp); s_ctmp=nullptr; s_ctmp_size=0; }
+  if (g_blockFirst){ free(g_blockFirst); g_blockFirst=nullptr; }
+  freeBlockCache();
+  freeRawReadAhead();
+  g_seqCur = nullptr;   // the entry itself stays resident
+  g_nativeSeq = false;
+  g_blockFrames = 0;
   g_compCount=0; g_compBase=0; g_compPerFrame=false;
+  g_loadUsLast = 0; g_decodeUsLast = 0; g_loadUsSum = 0; g_decodeUsSum = 0; g_loadCount = 0;
   g_bgEffectActive = false;
   memset(&g_fh,0,sizeof(g_fh));
   g_frameValid = false;
@@ -607,21 +1173,75 @@ static void freeFseq(){
   g_currentPath = "";
 }
 
+/* -------------------- Sparse channel translation -------------------- */
+static void indexSparseRanges() {
+  if (g_rangesSorted) { free(g_rangesSorted); g_rangesSorted = nullptr; }
+  g_sparseMode = XLATE_DENSE;
+  if (!g_fh.sparseCnt || !g_ranges) return;
+  SparseRange* sorted = nullptr;
+  if (g_fh.sparseCnt >= SPARSE_BSEARCH_MIN) sorted = (SparseRange*)malloc(sizeof(SparseRange) * g_fh.sparseCnt);
+  g_sparseMode = fseqIndexSparse(g_ranges, g_fh.sparseCnt, sorted);
+  if (g_sparseMode == XLATE_BSEARCH) g_rangesSorted = sorted;
+  else free(sorted);
+}
+
 static int64_t sparseTranslate(uint32_t absCh) {
-  if (g_fh.sparseCnt == 0) {
-    return (absCh < g_fh.channelCount) ? (int64_t)absCh : -1;
-  }
-  for (uint8_t i=0;i<g_fh.sparseCnt;++i){
-    const SparseRange &r = g_ranges[i];
-    if (absCh >= r.start && absCh < r.start + r.count) {
-      return (int64_t)r.accum + (absCh - r.start);
-    }
+  return fseqSparseTranslate(g_sparseMode, g_ranges, g_rangesSorted, g_fh.sparseCnt, g_fh.channelCount, absCh);
+}
+
+static const char* codecName(uint8_t comp){
+  switch (comp) { case 0: return "none"; case 1: return "zstd"; case 2: return "zlib"; default: return "?"; }
+}
+
+static bool codecAvailable(uint8_t comp){
+  switch (comp) {
+    case 0: return true;
+    case 1: return true;
+#if defined(MZ_OK) || defined(Z_OK)
+    case 2: return true;
+#endif
+    default: return false;
   }
-  return -1;
 }
 
-// was: static bool openFseq(const String& path, String& why)
-bool openFseq(const String& path, String& why){
+static bool buildBlockIndex(String& why){
+  if (!g_fh.channelCount || !g_fh.frameCount){ why="zero chans"; return false; }
+  if (!g_compCount){ why="no blocks"; return false; }
+  g_blockFirst = (uint32_t*)allocFrameMem(sizeof(uint32_t) * (g_compCount + 1));
+  if (!g_blockFirst){ why="oom bidx"; return false; }
+  const char* err = fseqBuildBlockIndex(g_cblocks, g_compCount, g_fh.channelCount, g_fh.frameCount,
+                                        g_blockFirst, g_blockFrames);
+  if (err){ why=err; return false; }
+  g_compPerFrame = (g_blockFrames == 1);
+  return true;
+}
+
+static uint32_t frameBlock(uint32_t idx){
+  return fseqFrameBlock(g_blockFirst, g_compCount, g_compPerFrame, idx);
+}
+
+// openFseq (SD held, source header in g_fh): the complete native twin of this
+// source, if it was built for the current mapping.  Fills g_povHdr.
+static bool openPolarTwin(const String& path, File& out){
+  const String p = path + POLAR_SUFFIX;
+  if (!SD_MMC.exists(p)) return false;
+  File f = SD_MMC.open(p, FILE_READ);
+  if (!f) return false;
+  uint8_t raw[POLAR_HEADER_BYTES];
+  PolarHeader h;
+  const bool ok = f.read(raw, sizeof(raw)) == sizeof(raw) && polarDecodeHeader(raw, h) && h.complete &&
+                  h.srcUniqueId == g_fh.uniqueId && h.srcFrames == g_fh.frameCount &&
+                  h.srcChannels == g_fh.channelCount && h.frameCount == g_fh.frameCount &&
+                  (uint64_t)f.size() == POLAR_HEADER_BYTES + (uint64_t)h.frameCount * h.frameBytes &&
+                  h.mapHash == mappingHash(g_fh.channelCount);
+  if (!ok) { f.close(); return false; }
+  g_povHdr = h;
+  out = f;
+  return true;
+}
+
+// Open path and start playing at startFrame (0 if past the end)
+static bool openFseqAt(const String& path, String& why, uint32_t startFrame){
   freeFseq();
   if (!g_sdMutex || !SD_LOCK(pdMS_TO_TICKS(2000))) { why="sd busy"; return false; }
   bool ok = false;
@@ -629,60 +1249,75 @@ bool openFseq(const String& path, String& why){
     g_fseq = SD_MMC.open(path, FILE_READ);
     if (!g_fseq){ why="open fail"; break; }
 
-    uint8_t magic[4]; if (g_fseq.read(magic,4)!=4){ why="short"; break; }
-    if (!((magic[0]=='F'||magic[0]=='P') && magic[1]=='S' && magic[2]=='E' && magic[3]=='Q')){ why="bad magic"; break; }
-
-    if (!readU16(g_fseq, g_fh.chanDataOffset) || g_fseq.read(&g_fh.minor,1)!=1 || g_fseq.read(&g_fh.major,1)!=1 ||
-        !readU16(g_fseq, g_fh.varDataOffset) || !readU32(g_fseq, g_fh.channelCount) ||
-        !readU32(g_fseq, g_fh.frameCount) || g_fseq.read(&g_fh.stepTimeMs,1)!=1 || g_fseq.read(&g_fh.flags,1)!=1) { why="hdr"; break; }
-
-    uint8_t ecct_ct_scc_res[4]; if (g_fseq.read(ecct_ct_scc_res,4)!=4){ why="hdr"; break; }
-    g_fh.compType     = (ecct_ct_scc_res[0] & 0x0F);
-    g_fh.compBlockCnt = ecct_ct_scc_res[1];
-    g_fh.sparseCnt    = ecct_ct_scc_res[2];
-    if (!readU64(g_fseq, g_fh.uniqueId)) { why="hdr"; break; }
+    uint8_t hdr[FSEQ_HEADER_BYTES];
+    if (g_fseq.read(hdr, sizeof(hdr)) != sizeof(hdr)){ why="short"; break; }
+    if (const char* err = fseqDecodeHeader(hdr, g_fh)){ why=err; break; }
+
+    // A complete native twin of this source for the current mapping plays instead
+    File twin;
+    if (openPolarTwin(path, twin)) {
+      g_fseq.close();
+      g_fseq = twin;
+      g_fh.channelCount   = g_povHdr.frameBytes;
+      g_fh.chanDataOffset = POLAR_HEADER_BYTES;
+      g_fh.compType = 0; g_fh.compBlockCnt = 0; g_fh.sparseCnt = 0;
+      g_nativeSeq = true;
+    }
 
     if (g_fh.compBlockCnt > 0) {
       g_cblocks = (CompBlock*)malloc(sizeof(CompBlock)*g_fh.compBlockCnt);
       if (!g_cblocks){ why="oom ctab"; break; }
+      bool tabOk = true;
       for (uint32_t i=0;i<g_fh.compBlockCnt;++i){
-        if (!readU32(g_fseq, g_cblocks[i].uSize) || !readU32(g_fseq, g_cblocks[i].cSize)) { why="ctab"; break; }
+        uint8_t b[FSEQ_COMP_ENTRY_BYTES];
+        if (g_fseq.read(b, sizeof(b)) != sizeof(b)) { tabOk=false; break; }
+        g_cblocks[i] = fseqDecodeCompBlock(b);
       }
-      g_compCount = g_fh.compBlockCnt;
+      if (!tabOk){ why="ctab"; break; }
+      g_compCount = fseqTrimBlocks(g_cblocks, g_fh.compBlockCnt);
+
+      // Prefix-offset index so frame/block lookup is O(1); PSRAM for big tables
+      g_compOffs = (uint64_t*)allocFrameMem(sizeof(uint64_t) * (g_compCount + 1));
+      if (!g_compOffs){ why="oom cidx"; break; }
+      fseqBlockOffsets(g_cblocks, g_compCount, g_fh.chanDataOffset, g_compOffs);
     }
 
     if (g_fh.sparseCnt > 0){
       g_ranges = (SparseRange*)malloc(sizeof(SparseRange)*g_fh.sparseCnt);
       if (!g_ranges){ why="oom ranges"; break; }
       uint32_t accum=0;
+      bool rangesOk = true;
       for (uint8_t i=0;i<g_fh.sparseCnt;++i){
-        uint8_t b[6]; if (g_fseq.read(b,6)!=6){ why="ranges"; break; }
-        uint32_t start = (uint32_t)b[0]|((uint32_t)b[1]<<8)|((uint32_t)b[2]<<16);
-        uint32_t count = (uint32_t)b[3]|((uint32_t)b[4]<<8)|((uint32_t)b[5]<<16);
-        g_ranges[i] = { start, count, accum };
-        accum += count;
+        uint8_t b[FSEQ_RANGE_BYTES]; if (g_fseq.read(b,sizeof(b))!=sizeof(b)){ rangesOk=false; break; }
+        g_ranges[i] = fseqDecodeRange(b, accum);
+        accum += g_ranges[i].count;
       }
+      if (!rangesOk){ why="ranges"; break; }
+      indexSparseRanges();
     }
 
     g_fseq.seek(g_fh.chanDataOffset, SeekSet);
+    // Native frames are keyed by mapping too: a rebuilt twin must not hit the old one's frames
+    seqCacheBind(g_nativeSeq ? path + POLAR_SUFFIX + "#" + String(g_povHdr.mapHash, HEX) : path);
+    const bool resident = seqCacheComplete();   // every frame in PSRAM: no read buffers needed
 
     if (g_fh.compType == 0) {
       g_compBase = g_fh.chanDataOffset;
-    } else if (g_fh.compType == 2) {
+      if (!resident) allocRawReadAhead(g_fh.channelCount);
+    } else if (g_fh.compType == 1 || g_fh.compType == 2) {
       g_compBase = g_fh.chanDataOffset;
-      bool perFrame = (g_compCount == g_fh.frameCount && g_fh.channelCount>0);
-      if (perFrame){ for (uint32_t i=0;i<g_compCount;++i){ if (g_cblocks[i].uSize != g_fh.channelCount){ perFrame=false; break; } } }
-#if defined(MZ_OK) || defined(Z_OK)
-      g_compPerFrame = perFrame;
-      if (!g_compPerFrame) { why="zlib block!=frame (not yet supported)"; break; }
-#else
-      (void)perFrame; why="zlib not available"; break;
-#endif
-    } else { why="zstd unsupported"; break; }
+      if (!resident && !codecAvailable(g_fh.compType)) { why = String(codecName(g_fh.compType)) + " not available"; break; }
+      if (!buildBlockIndex(why)) break;
+      if (!resident && !g_compPerFrame && !allocBlockCache((size_t)g_blockFrames * g_fh.channelCount)) { why="oom block"; break; }
+    } else { why="unknown compression"; break; }
 
     if (g_fh.channelCount==0){ why="zero chans"; break; }
-    g_frameBuf = (uint8_t*)malloc(g_fh.channelCount);
-    if (!g_frameBuf){ why="oom frame"; break; }
+    for (uint8_t i=0; i<FRAME_RING_DEPTH; ++i) {
+      g_ringBuf[i] = allocFrameMem(g_fh.channelCount);
+      if (!g_ringBuf[i]) break;
+      g_ringDepth = i + 1;
+    }
+    if (g_ringDepth < FRAME_RING_MIN){ why="oom frame"; break; }
 
     g_currentPath = path;
     g_frameIndex = 0;
@@ -695,14 +1330,27 @@ bool openFseq(const String& path, String& why){
   if (ok) {
     resetArmRuntimeStates();
     g_frameValid = false;
-    if (!loadNextFrame()) { why = "frame load"; ok = false; }
+    publishPixelLut();
+    if (startFrame >= g_fh.frameCount) startFrame = 0;
+    g_frameIndex = startFrame;
+    // The start frame is loaded synchronously so open errors still surface here
+    if (!loadFrame(startFrame, g_ringBuf[0])) { why = "frame load"; ok = false; }
     else {
-      g_lastTickMs = millis();
+      encodeSpokeWire(0);
+      g_ringFrame[0] = startFrame;
+      g_prefetchNext = (startFrame + 1) % g_fh.frameCount;
+      __atomic_store_n(&g_ringHead, 1u, __ATOMIC_RELEASE);
+      g_ringHighWater = 1;
+      g_ringUnderruns = 0;
+      g_prefetchRun = true;
+      if (g_prefetchTask) xTaskNotifyGive(g_prefetchTask);
+      g_clockRestart = true;
       g_playing = true;
       g_paused = false;
-      Serial.printf("[FSEQ] %s frames=%lu chans=%lu step=%ums comp=%u blocks=%u sparse=%u CDO=0x%04x\n",
+      Serial.printf("[FSEQ] %s frames=%lu chans=%lu step=%ums comp=%u blocks=%u sparse=%u CDO=0x%04x ring=%u native=%u\n",
         path.c_str(), (unsigned long)g_fh.frameCount, (unsigned long)g_fh.channelCount,
-        g_fh.stepTimeMs, g_fh.compType, (unsigned)g_compCount, (unsigned)g_fh.sparseCnt, g_fh.chanDataOffset);
+        g_fh.stepTimeMs, g_fh.compType, (unsigned)g_compCount, (unsigned)g_fh.sparseCnt, g_fh.chanDataOffset,
+        (unsigned)g_ringDepth, (unsigned)g_nativeSeq);
     }
   }
 
@@ -710,52 +1358,306 @@ bool openFseq(const String& path, String& why){
   return ok;
 }
 
-static bool loadFrame(uint32_t idx){
+// was: static bool openFseq(const String& path, String& why)
+bool openFseq(const String& path, String& why){
+  return openFseqAt(path, why, 0);
+}
+
+// Read compressed block b into s_ctmp (caller holds SD_LOCK)
+static bool readBlock(uint32_t b, uint32_t& clen){
+  StageTimer st(MS_SD_READ);
+  clen = g_cblocks[b].cSize;
+  if (!clen || clen > 8*1024*1024) return false;
+  if (!g_fseq.seek(g_compOffs[b], SeekSet)) return false;
+  if (s_ctmp_size < clen) {
+    uint8_t* nb = (uint8_t*)realloc(s_ctmp, clen);
+    if (!nb) return false;
+    s_ctmp = nb; s_ctmp_size = clen;
+  }
+  const uint32_t t0 = micros();
+  if (g_fseq.read(s_ctmp, clen) != clen) return false;
+  g_sdStats.readBytes += clen;
+  g_sdStats.readUs += micros() - t0;
+  return true;
+}
+
+// Codec dispatch only (producer task: the zstd context is not shared across tasks)
+static bool decompressBlock(const uint8_t* src, size_t srcLen, uint8_t* dst, size_t dstLen){
+  switch (g_fh.compType) {
+    case 1: return zstd_decompress(src, srcLen, dst, dstLen);
+#if defined(MZ_OK) || defined(Z_OK)
+    case 2: return zlib_decompress(src, srcLen, dst, dstLen);
+#endif
+    default: return false;
+  }
+}
+
+static bool decodeBlock(const uint8_t* src, size_t srcLen, uint8_t* dst, size_t dstLen){
+  StageTimer st(MS_INFLATE);
+  const uint32_t t0 = micros();
+  const bool ok = decompressBlock(src, srcLen, dst, dstLen);
+  g_decodeUsLast = micros() - t0;
+  g_decodeUsSum += g_decodeUsLast;
+  return ok;
+}
+
+// Decoded block b from the cache, inflating into the LRU slot on a miss
+// (caller holds SD_LOCK).  nullptr on read/decode failure.
+static const uint8_t* cachedBlock(uint32_t b){
+  BlockSlot* victim = nullptr;
+  for (uint8_t i=0; i<g_blockCacheSlots; ++i) {
+    BlockSlot& s = g_blockCache[i];
+    if (s.block == b) { s.lastUse = ++g_blockUseTick; ++g_blockHits; return s.buf; }
+    if (g_blockCacheSlots > 1 && s.block == 0) continue;   // keep the loop start
+    if (!victim || s.block == UINT32_MAX || (victim->block != UINT32_MAX && s.lastUse < victim->lastUse)) victim = &s;
+  }
+  if (!victim) return nullptr;
+  ++g_blockMisses;
+  const size_t bytes = (size_t)(g_blockFirst[b+1] - g_blockFirst[b]) * g_fh.channelCount;
+  uint32_t clen = 0;
+  victim->block = UINT32_MAX;
+  if (!readBlock(b, clen) || !decodeBlock(s_ctmp, clen, victim->buf, bytes)) return nullptr;
+  victim->block   = b;
+  victim->lastUse = ++g_blockUseTick;
+  return victim->buf;
+}
+
+// Raw frame bytes at file offset `base` (caller holds SD_LOCK).  Served from
+// the read-ahead window, refilled from the sector below `base` on a miss.
+static bool rawRead(uint64_t base, uint8_t* dst, uint32_t len){
+  if (!g_raBuf) {
+    const uint32_t t0 = micros();
+    if (!g_fseq.seek(base, SeekSet) || g_fseq.read(dst, len) != len) return false;
+    g_sdStats.readBytes += len;
+    g_sdStats.readUs += micros() - t0;
+    return true;
+  }
+  if (base < g_raOff || base + len > g_raOff + g_raLen) {
+    const uint32_t t0 = micros();
+    const uint64_t off  = base & ~(uint64_t)(RAW_RA_ALIGN - 1);
+    const uint64_t size = (uint64_t)g_fseq.size();
+    size_t n = g_raCap;
+    if (off + n > size) n = (size > off) ? (size_t)(size - off) : 0;
+    g_raLen = 0;
+    if (off + n < base + len || !g_fseq.seek(off, SeekSet) || g_fseq.read(g_raBuf, n) != n) return false;
+    g_raOff = off;
+    g_raLen = n;
+    ++g_raFills;
+    g_raBytes += n;
+    g_raFillUsLast = micros() - t0;
+    g_raFillUsSum += g_raFillUsLast;
+    g_sdStats.readBytes += n;
+    g_sdStats.readUs += g_raFillUsLast;
+  } else {
+    ++g_raHits;
+  }
+  memcpy(dst, g_raBuf + (size_t)(base - g_raOff), len);
+  return true;
+}
+
+static bool loadFrame(uint32_t idx, uint8_t* dst){
   if (!g_fseq || !g_fh.frameCount) return false;
   idx %= g_fh.frameCount;
 
-  if (!g_sdMutex || !SD_LOCK(pdMS_TO_TICKS(2000))) return false;
+  StageTimer st(MS_FRAME_LOAD);
+  if (seqCacheHas(idx)) {
+    const uint32_t t0 = micros();
+    memcpy(dst, g_seqCur->data + (size_t)idx * g_fh.channelCount, g_fh.channelCount);
+    ++g_seqHits;
+    g_loadUsLast = micros() - t0;
+    g_loadUsSum += g_loadUsLast;
+    if (g_benchOn) g_benchLoadUs.add(g_loadUsLast);
+    ++g_loadCount;
+    return true;
+  }
+  {
+    StageTimer lk(MS_SD_LOCK);
+    if (!g_sdMutex || !SD_LOCK(pdMS_TO_TICKS(2000))) return false;
+  }
+  const uint32_t t0 = micros();
+  const uint32_t chans = g_fh.channelCount;
   bool ok=false;
 
   if (g_fh.compType == 0){
-    const uint64_t base = (uint64_t)g_fh.chanDataOffset + (uint64_t)idx * (uint64_t)g_fh.channelCount;
-    if (g_fseq.seek(base, SeekSet))
-      ok = (g_fseq.read(g_frameBuf, g_fh.channelCount) == g_fh.channelCount);
+    const uint64_t base = (uint64_t)g_fh.chanDataOffset + (uint64_t)idx * (uint64_t)chans;
+    StageTimer rd(MS_SD_READ);
+    ok = rawRead(base, dst, chans);
+  } else if (g_blockFirst) {
+    const uint32_t b = frameBlock(idx);
+    if (g_compPerFrame) {
+      uint32_t clen = 0;
+      ok = readBlock(b, clen) && decodeBlock(s_ctmp, clen, dst, chans);
+    } else if (const uint8_t* blk = cachedBlock(b)) {
+      memcpy(dst, blk + (size_t)(idx - g_blockFirst[b]) * chans, chans);
+      ok = true;
+    }
   }
-#if defined(MZ_OK) || defined(Z_OK)
-  else if (g_fh.compType == 2 && g_compPerFrame){
-    uint64_t offs = g_compBase;
-    for (uint32_t i=0;i<idx;++i) offs += g_cblocks[i].cSize;
-    if (g_fseq.seek(offs, SeekSet)) {
-      uint32_t clen = g_cblocks[idx].cSize;
-      if (clen && clen <= 8*1024*1024) {
-        if (s_ctmp_size < clen) {
-          uint8_t* nb = (uint8_t*)realloc(s_ctmp, clen);
-          if (!nb) { SD_UNLOCK(); return false; }
-          s_ctmp = nb; s_ctmp_size = clen;
+  SD_UNLOCK();
+  if (ok) {
+    seqCacheStore(idx, dst);
+    g_loadUsLast = micros() - t0;
+    g_loadUsSum += g_loadUsLast;
+    if (g_benchOn) g_benchLoadUs.add(g_loadUsLast);
+    ++g_loadCount;
+  } else {
+    ++g_sdStats.readErrors;
+  }
+  return ok;
+}
+
+// Producer: keeps the ring topped up.  Sleeps on a task notification from the
+// render core (slot released) or openFseq (new file).
+static void prefetchTask(void*){
+  for (;;) {
+    bool loaded = false, busy = false;
+    if (xSemaphoreTake(g_pipeMutex, portMAX_DELAY) == pdTRUE) {
+      if (g_prefetchRun && !g_prefetchFailed && g_ringDepth && g_fh.frameCount) {
+        const uint32_t head = g_ringHead;
+        if (head - __atomic_load_n(&g_ringTail, __ATOMIC_ACQUIRE) < (uint32_t)(g_ringDepth - 1)) {
+          const uint8_t  slot = head % g_ringDepth;
+          uint32_t idx = g_prefetchNext;
+          // Nothing queued and already behind the frame clock: skip to the frame due now
+          const uint32_t want = __atomic_load_n(&g_frameWanted, __ATOMIC_ACQUIRE);
+          if (want != UINT32_MAX && head == __atomic_load_n(&g_ringTail, __ATOMIC_ACQUIRE) &&
+              frameLag(idx, want, g_fh.frameCount) > 0) idx = want;
+          if (loadFrame(idx, g_ringBuf[slot])) {
+            encodeSpokeWire(slot);
+            g_ringFrame[slot] = idx;
+            g_prefetchNext = (idx + 1) % g_fh.frameCount;
+            __atomic_store_n(&g_ringHead, head + 1, __ATOMIC_RELEASE);
+            uint32_t fill = ringFill();
+            if (fill > g_ringHighWater) g_ringHighWater = fill;
+            g_sdFailStreak = 0;
+            loaded = true;
+          } else {
+            g_prefetchFailed = true;
+          }
+        } else {
+          busy = polarJobStep();   // ring full: spare SD time goes to the transcode
         }
-        size_t got = g_fseq.read(s_ctmp, clen);
-        if (got == clen) ok = zlib_decompress(s_ctmp, clen, g_frameBuf, g_fh.channelCount);
       }
+      xSemaphoreGive(g_pipeMutex);
     }
+    if (!loaded) ulTaskNotifyTake(pdTRUE, busy ? 1 : pdMS_TO_TICKS(20));
   }
-#endif
-  SD_UNLOCK();
-  return ok;
 }
 
-static bool loadNextFrame(){
-  if (!g_fseq || !g_fh.frameCount) return false;
-  uint32_t count = g_fh.frameCount;
-  uint32_t idx = g_frameIndex % count;
-  if (!loadFrame(idx)) return false;
-  g_frameIndex = (idx + 1) % count;
+// SD_Functions upload writer: playback is running with fewer than two frames
+// queued, so the producer should get the card first
+bool playbackNeedsSd(){
+  return g_playing && !g_paused && g_prefetchRun && g_ringDepth && ringFill() < 2;
+}
+
+// Frame index in the oldest ring slot, if any
+static bool ringPeekFrame(uint32_t& f){
+  const uint32_t tail = g_ringTail;
+  if (!g_ringDepth || __atomic_load_n(&g_ringHead, __ATOMIC_ACQUIRE) == tail) return false;
+  f = g_ringFrame[tail % g_ringDepth];
+  return true;
+}
+
+// Render core: show the next decoded frame if one is ready.  Never touches SD.
+static bool advanceFrameRing(){
+  const uint32_t tail = g_ringTail;
+  if (!g_ringDepth || __atomic_load_n(&g_ringHead, __ATOMIC_ACQUIRE) == tail) return false;
+  const uint8_t slot = tail % g_ringDepth;
+  g_frameBuf   = g_ringBuf[slot];
+  g_frameWire  = &g_ringWire[slot];
+  g_frameIndex = g_ringFrame[slot];
   g_frameValid = true;
+  __atomic_store_n(&g_ringTail, tail + 1, __ATOMIC_RELEASE);
+  if (g_prefetchTask) xTaskNotifyGive(g_prefetchTask);
   return true;
 }
 
+// Render core side of RCMD_RING_FLUSH.  Only the render core writes the tail.
+static void flushFrameRing(){
+  __atomic_store_n(&g_ringTail, __atomic_load_n(&g_ringHead, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+  g_ringStarved  = true;                      // the gap after a seek is not an underrun
+  g_clockRestart = true;                      // the clock restarts on the target frame
+  __atomic_store_n(&g_frameWanted, UINT32_MAX, __ATOMIC_RELEASE);
+}
+
+// Frame period as num/den us: the file's step time, or the /speed override
+static void frameRate(uint32_t& num, uint32_t& den){
+  if (g_fpsFromFile && g_fh.stepTimeMs) { num = (uint32_t)g_fh.stepTimeMs * 1000UL; den = 1; }
+  else { num = 1000000UL; den = g_fps ? g_fps : 40; }
+}
+
+// Render core frame clock, locked to the sequence timebase.  Shows the newest
+// queued frame the clock has reached; frames it has already passed are dropped
+// so a stall does not stretch the show.  Counts ring underruns.
+static void tickFrameClock(){
+  const uint32_t now   = micros();
+  const uint32_t count = g_fh.frameCount;
+  if (!count) return;
+  if (g_clockRestart || !g_frameValid || !g_frameClock.running()) {
+    // Open / seek / resume / rate change: the clock starts on the next frame that lands
+    if (!advanceFrameRing()) return;
+    g_clockRestart = false;
+    g_swapPending  = false;
+    uint32_t num, den;
+    frameRate(num, den);
+    g_frameClock.setRate(num, den);
+    g_frameClock.start(now);
+    g_clockFrame  = g_frameIndex;
+    g_ringStarved = false;
+    __atomic_store_n(&g_frameWanted, g_clockFrame, __ATOMIC_RELEASE);
+    return;
+  }
+  const uint32_t due = g_frameClock.advance(now);
+  if (due) {
+    g_clockFrame = (uint32_t)((g_clockFrame + (uint64_t)due) % count);
+    __atomic_store_n(&g_frameWanted, g_clockFrame, __ATOMIC_RELEASE);
+  }
+  if (frameLag(g_frameIndex, g_clockFrame, count) <= 0) { g_swapPending = false; return; }   // on time
+
+  uint32_t f;
+  const bool ready = ringPeekFrame(f) && frameLag(f, g_clockFrame, count) >= 0;
+  if (ready && g_swapAlign && g_sched.running()) {
+    // Hold the frame for the next revolution boundary
+    if (!g_swapPending) { g_swapPending = true; g_swapPendingUs = now; ++g_swapsDeferred; }
+    if ((uint32_t)(now - g_swapPendingUs) < (uint32_t)g_swapTimeoutMs * 1000UL) return;
+    ++g_swapsForced;
+  } else if (ready && !g_swapPending) {
+    ++g_swapsImmediate;
+  }
+  swapToClockFrame();
+}
+
+// Put the newest queued frame the clock has reached on screen; passed frames
+// are dropped.  The frame pointers only change here, on the render core,
+// between spokes.
+static void swapToClockFrame(){
+  const uint32_t count = g_fh.frameCount;
+  g_swapPending = false;
+  if (!count) return;
+  const uint32_t prev = g_frameIndex;
+  bool moved = false;
+  uint32_t f;
+  while (ringPeekFrame(f) && frameLag(f, g_clockFrame, count) >= 0) { advanceFrameRing(); moved = true; }
+  if (moved) {
+    g_framesDropped += (g_frameIndex + count - prev - 1) % count;
+    g_ringStarved = false;
+  } else if (!g_ringStarved) {
+    g_ringStarved = true;   // count each stall once; keep the old frame up until one arrives
+    ++g_ringUnderruns;
+  }
+}
+
+// Revolution boundary reached at spoke `step`: apply a held frame swap.
+// The strobe path only has the Hall sync as a boundary.  The stored spoke is
+// taken modulo the current count, so a later /mapcfg with fewer spokes does
+// not leave swaps waiting for a step that never comes.
+static void swapAtBoundary(uint16_t step){
+  if (!g_swapPending) return;
+  if (step != g_swapStep % spokesCount() && !(step == 0 && g_strobeEnable)) return;
+  ++g_swapsAligned;
+  swapToClockFrame();
+}
+
 /* -------------------- Color mapping -------------------- */
-enum ColorMap { MAP_RGB, MAP_RBG, MAP_GBR, MAP_GRB, MAP_BRG, MAP_BGR };
+// ColorMap lives in SpokeKernels.h (the kernels are specialised on it)
 ColorMap g_colorMap = MAP_RGB;
 
 static inline void mapChannels(const uint8_t* p, uint8_t& r, uint8_t& g, uint8_t& b) {
@@ -786,30 +1688,441 @@ static void computeDefaultArmStarts(uint32_t startArm1) {
   }
 }
 
+/* -------------------- Spoke/pixel -> frame offset table -------------------- */
+// One int32 frame byte offset (R of the pixel, -1 = not in file) per
+// (arm, spoke slice, pixel).  Built on the I/O core at open and on /mapcfg,
+// installed on the render core via RCMD_PIXLUT, so paintArmAt() is a plain gather.
+// When the table does not fit (no PSRAM, many slices x long arms) off is null
+// and each row is translated per spoke into a scratch row instead (lutRow()).
+struct PixelLut {
+  uint8_t  arms;
+  uint16_t slices;   // 1 when each frame holds one spoke, else spokesCount()
+  uint16_t pixels;
+  bool     dense;    // no -1 entries: kernels skip the hole check
+  int32_t* off;      // arms * slices * pixels, stored after the header (null: direct)
+  uint32_t chans;                  // direct rows: source layout
+  uint32_t chPerSpoke;
+  uint32_t armBase[MAX_ARMS];
+};
+static PixelLut* g_pixLut = nullptr;   // owned by the render core
+static PixelLut* buildPixelLut();
+static void installPixelLut(PixelLut* lut);
+static bool translateLutRow(const PixelLut* lut, uint8_t arm, uint16_t slice, int32_t* o);
+static inline const int32_t* lutRow(const PixelLut* lut, uint8_t arm, uint16_t slice, int32_t* scratch);
+
+// Frame layout of a `chans`-channel source: one spoke per frame, or all spokes
+// sliced into chPerSpoke blocks
+static void spokeFrameLayout(uint32_t chans, bool &perSpokeFrame, uint32_t &chPerSpoke) {
+  pixelFrameLayout(chans, activeArmCount(), armPixelCount(), spokesCount(), perSpokeFrame, chPerSpoke);
+}
+
+// Base (R) channel for this arm, pixel 0 (1-based -> 0-based)
+static uint32_t armBaseChannel(uint8_t arm) {
+  if (g_usePerArmStart) return (g_startChArm[arm] ? g_startChArm[arm]-1 : 0);
+  const uint32_t base = (g_startChArm1 ? g_startChArm1-1 : 0);
+  return base + (uint32_t)arm * (uint32_t)armPixelCount() * 3u;
+}
+
+// Everything a native file bakes in for a `chans`-channel source: layout, start
+// channels, colour order and arm reversal (lane placement is applied at paint)
+static uint32_t mappingHash(uint32_t chans) {
+  bool perSpokeFrame; uint32_t chPerSpoke;
+  spokeFrameLayout(chans, perSpokeFrame, chPerSpoke);
+  const uint8_t  arms   = activeArmCount();
+  const uint16_t pixels = armPixelCount();
+  const uint16_t slices = perSpokeFrame ? 1 : spokesCount();
+  const uint8_t  cm     = (uint8_t)g_colorMap;
+  uint32_t h = FNV1A_INIT;
+  h = fnv1a(h, &arms, sizeof(arms));
+  h = fnv1a(h, &pixels, sizeof(pixels));
+  h = fnv1a(h, &slices, sizeof(slices));
+  h = fnv1a(h, &chPerSpoke, sizeof(chPerSpoke));
+  h = fnv1a(h, &cm, sizeof(cm));
+  for (uint8_t a = 0; a < arms; ++a) {
+    const uint32_t base = armBaseChannel(a);
+    const uint8_t  rev  = g_armRoute[a].reverse ? 1 : 0;
+    h = fnv1a(h, &base, sizeof(base));
+    h = fnv1a(h, &rev, sizeof(rev));
+  }
+  return h;
+}
+
+// Frame offsets of one (arm, slice) row; false if any pixel is a hole
+static bool translateLutRow(const PixelLut* lut, uint8_t arm, uint16_t slice, int32_t* o) {
+  return pixelRowOffsets(lut->armBase[arm], slice, lut->chPerSpoke, lut->pixels, lut->chans,
+                         [](uint32_t ch) { return sparseTranslate(ch); }, o);
+}
+
+// Row of the table, or (direct) the row translated into scratch (pixels entries)
+static inline const int32_t* lutRow(const PixelLut* lut, uint8_t arm, uint16_t slice, int32_t* scratch) {
+  if (lut->off) return lut->off + ((size_t)arm * lut->slices + slice) * lut->pixels;
+  translateLutRow(lut, arm, slice, scratch);
+  return scratch;
+}
+
+static PixelLut* buildPixelLut() {
+  if (!g_fh.channelCount) return nullptr;
+  const uint8_t  arms   = activeArmCount();
+  const uint16_t pixels = armPixelCount();
+  bool perSpokeFrame; uint32_t chPerSpoke;
+  spokeFrameLayout(g_fh.channelCount, perSpokeFrame, chPerSpoke);
+  const uint16_t slices = perSpokeFrame ? 1 : spokesCount();
+
+  const size_t entries = (size_t)arms * slices * pixels;
+  PixelLut* lut = (PixelLut*)allocFrameMem(sizeof(PixelLut) + entries * sizeof(int32_t));
+  const bool direct = !lut;
+  if (direct) lut = (PixelLut*)malloc(sizeof(PixelLut));
+  if (!lut) { Serial.println("[LUT] oom"); return nullptr; }
+  lut->arms = arms; lut->slices = slices; lut->pixels = pixels;
+  lut->off = direct ? nullptr : (int32_t*)(lut + 1);
+  lut->chans = g_fh.channelCount;
+  lut->chPerSpoke = chPerSpoke;
+  for (uint8_t a = 0; a < MAX_ARMS; ++a) lut->armBase[a] = a < arms ? armBaseChannel(a) : 0;
+
+  const uint32_t t0 = micros();
+  static int32_t scratch[MAX_PIXELS_PER_ARM];   // I/O core only
+  lut->dense = true;
+  for (uint8_t a = 0; a < arms; ++a) {
+    for (uint16_t sl = 0; sl < slices; ++sl) {
+      int32_t* o = direct ? scratch : lut->off + ((size_t)a * slices + sl) * pixels;
+      if (!translateLutRow(lut, a, sl, o)) lut->dense = false;
+    }
+  }
+  Serial.printf("[LUT] %u arms x %u slices x %u px %s in %lu us\n",
+                (unsigned)arms, (unsigned)slices, (unsigned)pixels,
+                direct ? "direct (no room for the table)" : "built", (unsigned long)(micros() - t0));
+  return lut;
+}
+
+// Render core output stage: level table, LED header and one kernel per arm.
+// Re-picked whenever the table, routes or levels change, never per spoke.
+static uint8_t     g_renderLvl[256];
+static uint8_t     g_renderHdr = 0xFF;
+static SpokeKernel g_paintKernel[MAX_ARMS] = { nullptr };
+static bool        g_renderLevelsId = true;   // identity levels: native words go out as stored
+
+static void selectPaintKernels() {
+  const PixelLut* lut = g_pixLut;
+  const bool levels = !levelsAreIdentity(g_renderLvl, g_renderHdr);
+  g_renderLevelsId = !levels;
+  for (uint8_t a = 0; a < MAX_ARMS; ++a)
+    g_paintKernel[a] = lut ? pickSpokeKernel(g_colorMap, !lut->dense, levels, g_armRoute[a].reverse) : nullptr;
+}
+
+static void refreshLaneLevels() {
+  computeLevels(g_brightness, g_gammaX10, g_renderLvl, g_renderHdr);
+  for (uint8_t l=0; l<NUM_LANES; ++l) if (g_lanes[l]) g_lanes[l]->setLevels(g_renderLvl, g_renderHdr);
+  if (g_par) g_par->setLevels(g_renderLvl, g_renderHdr);
+  selectPaintKernels();
+}
+
+// Render core side of RCMD_PIXLUT
+static void installPixelLut(PixelLut* lut) {
+  PixelLut* old = g_pixLut;
+  g_pixLut = lut;
+  if (old) free(old);
+  selectPaintKernels();
+}
+
+// I/O core: rebuild for the current file + mapping and hand it to the render core.
+// The producer is parked while its copy of the pointer is swapped; the render
+// core frees the previous table once it installs this one.
+// A native sequence needs no table; a mapping it was not built for sends the
+// player back to the source (and, from there, to a fresh transcode).
+static void publishPixelLut() {
+  const bool run = g_prefetchRun;
+  stopPrefetch();
+  g_mapHash = g_fh.channelCount ? mappingHash(g_nativeSeq ? g_povHdr.srcChannels : g_fh.channelCount) : 0;
+  if (g_nativeSeq && g_mapHash != g_povHdr.mapHash) g_povReopen = true;
+  PixelLut* lut = g_nativeSeq ? nullptr : buildPixelLut();
+  if (renderPost(RCMD_PIXLUT, lut)) g_encLut = lut;
+  else if (lut) free(lut);
+  __atomic_add_fetch(&g_encGen, 1, __ATOMIC_RELEASE);
+  polarJobSync();
+  g_prefetchRun = run;
+  if (run && g_prefetchTask) xTaskNotifyGive(g_prefetchTask);
+}
+
+// Producer: transcode a loaded ring slot into per-spoke wire words using the
+// current offset table, colour map and brightness.  Leaves the slot stale
+// (generic paint) when there is no table or no memory for it.
+static void encodeSpokeWire(uint8_t slot){
+  SpokeWire& w = g_ringWire[slot];
+  w.gen = 0;
+  const PixelLut* lut = g_encLut;
+  const uint8_t* frame = g_ringBuf[slot];
+  if (!lut || !frame) return;
+  const uint32_t gen = __atomic_load_n(&g_encGen, __ATOMIC_ACQUIRE);
+
+  const uint16_t n = lut->pixels;
+  const size_t bytes = (size_t)lut->arms * lut->slices * n * 4;
+  if (w.cap < bytes) {
+    if (w.words) { free(w.words); w.words = nullptr; w.cap = 0; }
+    if (!psramFound() && bytes > SPOKE_WIRE_MAX_INTERNAL) return;
+    w.words = allocFrameMem(bytes);
+    if (!w.words) return;
+    w.cap = bytes;
+  }
+
+  uint8_t lvl[256], hdr;
+  computeLevels(g_brightness, g_gammaX10, lvl, hdr);
+  const bool levels = !levelsAreIdentity(lvl, hdr);
+
+  static int32_t row[MAX_PIXELS_PER_ARM];   // producer only
+  uint8_t* dst = w.words;
+  for (uint8_t a = 0; a < lut->arms; ++a) {
+    const SpokeKernel k = pickSpokeKernel(g_colorMap, !lut->dense, levels, g_armRoute[a].reverse);
+    for (uint16_t sl = 0; sl < lut->slices; ++sl, dst += (size_t)n * 4) k(frame, lutRow(lut, a, sl, row), n, lvl, hdr, dst);
+  }
+  w.arms = lut->arms; w.slices = lut->slices; w.pixels = n;
+  w.gen = gen;
+}
+
+/* -------------------- Spinner-native transcode -------------------- */
+// Producer: one source frame -> native words, spoke-major, full brightness
+static void encodePolarFrame(const uint8_t* frame, uint8_t* dst){
+  const PixelLut* lut = g_encLut;
+  const uint16_t n = lut->pixels;
+  SpokeKernel k[MAX_ARMS];
+  for (uint8_t a = 0; a < lut->arms; ++a) k[a] = pickSpokeKernel(g_colorMap, !lut->dense, false, g_armRoute[a].reverse);
+  static int32_t row[MAX_PIXELS_PER_ARM];   // producer only
+  for (uint16_t sl = 0; sl < lut->slices; ++sl) {
+    for (uint8_t a = 0; a < lut->arms; ++a, dst += (size_t)n * 4)
+      k[a](frame, lutRow(lut, a, sl, row), n, nullptr, 0xFF, dst);
+  }
+}
+
+static void polarJobFree(){
+  if (g_pov.file) g_pov.file.close();
+  if (g_pov.in) g_pov.in.close();
+  if (g_pov.src) { free(g_pov.src); g_pov.src = nullptr; }
+  if (g_pov.out) { free(g_pov.out); g_pov.out = nullptr; }
+  if (g_pov.cbuf) { free(g_pov.cbuf); g_pov.cbuf = nullptr; }
+  if (g_pov.blk) { free(g_pov.blk); g_pov.blk = nullptr; }
+  g_pov.blkIdx = UINT32_MAX;
+  g_pov.inPos = g_pov.outPos = 0;
+  g_pov.outReady = false;
+  g_pov.active = false;
+}
+
+// Drop a running job and its partial file (producer parked or the producer itself)
+static void polarJobAbort(const char* why){
+  if (!g_pov.active) return;
+  if (g_sdMutex && SD_LOCK(pdMS_TO_TICKS(2000))) {
+    g_pov.file.close();
+    SD_MMC.remove(g_pov.path);
+    SD_UNLOCK();
+  }
+  polarJobFree();
+  ++g_pov.aborted;
+  g_pov.lastError = why;
+  Serial.printf("[POV] %s aborted at frame %lu: %s\n", g_pov.path.c_str(), (unsigned long)g_pov.next, why);
+}
+
+// I/O core, producer parked: start converting the open sequence for the
+// current offset table.  Records the attempt so it runs once per file + mapping.
+static bool polarJobStart(){
+  polarJobAbort("restarted");
+  g_pov.triedId   = g_fh.uniqueId;
+  g_pov.triedHash = g_mapHash;
+  const PixelLut* lut = g_encLut;
+  if (!lut || !g_fseq || g_nativeSeq || !g_fh.frameCount || !g_currentPath.length()) { g_pov.lastError = "nothing to convert"; return false; }
+
+  PolarHeader h;
+  h.arms = lut->arms; h.slices = lut->slices; h.pixels = lut->pixels;
+  h.stepTimeMs  = g_fh.stepTimeMs;
+  h.frameCount  = g_fh.frameCount;
+  h.frameBytes  = polarFrameBytes(h.arms, h.slices, h.pixels);
+  h.mapHash     = g_mapHash;
+  h.srcUniqueId = g_fh.uniqueId;
+  h.srcFrames   = g_fh.frameCount;
+  h.srcChannels = g_fh.channelCount;
+
+  const bool compressed = (g_fh.compType != 0);
+  if (compressed && !g_blockFirst) { g_pov.lastError = "nothing to convert"; return false; }
+  uint32_t maxC = 0;
+  for (uint32_t b = 0; compressed && b < g_compCount; ++b) maxC = std::max(maxC, g_cblocks[b].cSize);
+  g_pov.src = allocFrameMem(g_fh.channelCount);
+  g_pov.out = allocFrameMem(h.frameBytes);
+  if (compressed) g_pov.cbuf = allocFrameMem(maxC);
+  if (compressed && !g_compPerFrame) g_pov.blk = allocFrameMem((size_t)g_blockFrames * g_fh.channelCount);
+  if (!g_pov.src || !g_pov.out || (compressed && !g_pov.cbuf) || (compressed && !g_compPerFrame && !g_pov.blk)) {
+    polarJobFree(); g_pov.lastError = "oom"; return false;
+  }
+
+  const String path = g_currentPath + POLAR_SUFFIX;
+  uint8_t raw[POLAR_HEADER_BYTES];
+  polarEncodeHeader(h, raw);   // complete = false until the last frame is in
+  bool ok = false;
+  if (g_sdMutex && SD_LOCK(pdMS_TO_TICKS(2000))) {
+    g_pov.in = SD_MMC.open(g_currentPath, FILE_READ);
+    if (g_pov.in) {
+      if (SD_MMC.exists(path)) SD_MMC.remove(path);
+      g_pov.file = SD_MMC.open(path, FILE_WRITE);
+      ok = g_pov.file && g_pov.file.write(raw, sizeof(raw)) == sizeof(raw);
+      if (!ok && g_pov.file) { g_pov.file.close(); SD_MMC.remove(path); }
+    }
+    SD_UNLOCK();
+  }
+  if (!ok) { polarJobFree(); g_pov.lastError = g_pov.in ? "create failed" : "source open failed"; return false; }
+
+  g_pov.path = path; g_pov.hdr = h; g_pov.next = 0;
+  g_pov.readBytes = 0;
+  g_pov.startMs = millis();
+  g_pov.lastError = "";
+  g_pov.active = true;
+  Serial.printf("[POV] transcoding %s: %lu frames x %lu B\n", path.c_str(), (unsigned long)h.frameCount, (unsigned long)h.frameBytes);
+  return true;
+}
+
+// I/O core, producer parked: keep the job in step with the open file and mapping
+static void polarJobSync(){
+  if (g_pov.active && (g_nativeSeq || g_pov.hdr.mapHash != g_mapHash || g_pov.hdr.srcUniqueId != g_fh.uniqueId))
+    polarJobAbort("mapping changed");
+  if (!g_pov.active && g_povAuto && !g_nativeSeq && g_encLut &&
+      (g_pov.triedId != g_fh.uniqueId || g_pov.triedHash != g_mapHash)) polarJobStart();
+}
+
+static void polarJobFinish(){
+  PolarHeader h = g_pov.hdr;
+  h.complete = true;
+  uint8_t raw[POLAR_HEADER_BYTES];
+  polarEncodeHeader(h, raw);
+  bool ok = false;
+  if (g_sdMutex && SD_LOCK(pdMS_TO_TICKS(2000))) {
+    ok = g_pov.file.seek(0, SeekSet) && g_pov.file.write(raw, sizeof(raw)) == sizeof(raw);
+    g_pov.file.close();
+    SD_UNLOCK();
+  }
+  if (!ok) { polarJobAbort("finalize failed"); return; }
+  g_pov.lastMs = millis() - g_pov.startMs;
+  ++g_pov.done;
+  Serial.printf("[POV] %s done in %lu ms\n", g_pov.path.c_str(), (unsigned long)g_pov.lastMs);
+  polarJobFree();
+  g_povReopen = true;   // switch the player over to it
+}
+
+// Producer: read up to `budget` bytes towards source frame g_pov.next on the
+// job's own handle.  1 = g_pov.src holds the frame, 0 = partial, -1 = error.
+static int polarJobRead(uint32_t budget, uint32_t& used){
+  const uint32_t chans = g_fh.channelCount;
+  const uint32_t idx = g_pov.next;
+  uint32_t b = 0, need = chans;
+  uint64_t base = (uint64_t)g_fh.chanDataOffset + (uint64_t)idx * chans;
+  uint8_t* dst = g_pov.src;
+  if (g_fh.compType != 0) {
+    b = frameBlock(idx);
+    if (g_pov.blk && g_pov.blkIdx == b) {
+      memcpy(g_pov.src, g_pov.blk + (size_t)(idx - g_blockFirst[b]) * chans, chans);
+      return 1;
+    }
+    base = g_compOffs[b]; need = g_cblocks[b].cSize; dst = g_pov.cbuf;
+  }
+  const uint32_t n = std::min(need - g_pov.inPos, budget);
+  if (!g_sdMutex || !SD_LOCK(pdMS_TO_TICKS(2000))) return -1;
+  const bool ok = g_pov.in.seek(base + g_pov.inPos, SeekSet) && g_pov.in.read(dst + g_pov.inPos, n) == n;
+  SD_UNLOCK();
+  if (!ok) return -1;
+  used += n; g_pov.inPos += n; g_pov.readBytes += n;
+  if (g_pov.inPos < need) return 0;
+  g_pov.inPos = 0;
+  if (g_fh.compType == 0) return 1;
+  if (!g_pov.blk) return decompressBlock(g_pov.cbuf, need, g_pov.src, chans) ? 1 : -1;   // one frame per block
+  const size_t bytes = (size_t)(g_blockFirst[b + 1] - g_blockFirst[b]) * chans;
+  g_pov.blkIdx = UINT32_MAX;
+  if (!decompressBlock(g_pov.cbuf, need, g_pov.blk, bytes)) return -1;
+  g_pov.blkIdx = b;
+  memcpy(g_pov.src, g_pov.blk + (size_t)(idx - g_blockFirst[b]) * chans, chans);
+  return 1;
+}
+
+// Producer, ring full: advance the job by up to POLAR_STEP_BYTES of SD traffic
+// or POLAR_STEP_US, whichever comes first.  false when there is no job.
+static bool polarJobStep(){
+  if (!g_pov.active) return false;
+  const PixelLut* lut = g_encLut;
+  const PolarHeader& h = g_pov.hdr;
+  if (!lut || lut->arms != h.arms || lut->slices != h.slices || lut->pixels != h.pixels) { polarJobAbort("mapping changed"); return false; }
+  const uint32_t t0 = micros();
+  uint32_t used = 0;
+  while (g_pov.next < h.frameCount && used < POLAR_STEP_BYTES && micros() - t0 < POLAR_STEP_US) {
+    if (!g_pov.outReady) {
+      const int r = polarJobRead(POLAR_STEP_BYTES - used, used);
+      if (r < 0) { polarJobAbort("read failed"); return false; }
+      if (r == 0) continue;
+      encodePolarFrame(g_pov.src, g_pov.out);
+      g_pov.outReady = true;
+      g_pov.outPos = 0;
+      continue;
+    }
+    const uint32_t n = std::min(h.frameBytes - g_pov.outPos, POLAR_STEP_BYTES - used);
+    bool ok = false;
+    if (g_sdMutex && SD_LOCK(pdMS_TO_TICKS(2000))) {
+      ok = g_pov.file.write(g_pov.out + g_pov.outPos, n) == n;
+      SD_UNLOCK();
+    }
+    if (!ok) { polarJobAbort("write failed"); return false; }
+    used += n; g_pov.outPos += n;
+    if (g_pov.outPos == h.frameBytes) { g_pov.outReady = false; ++g_pov.next; }
+  }
+  if (g_pov.next >= h.frameCount) polarJobFinish();
+  return true;
+}
+
 /* -------------------- Rebuild TWO-LANE strips and arm routes -------------------- */
+// Parallel mode: one line per arm on the old 4-arm ports, every arm outside-fed
+static bool buildParallel(uint16_t nPerArm){
+  g_par = new ParallelOutput();
+  if (g_par->begin(ARM_DATA, ARM_CLK, MAX_ARMS, nPerArm, PAR_PCLK_HZ)) {
+    for (uint8_t a=0;a<MAX_ARMS;++a) g_armRoute[a] = { a, 0, false };
+    for (uint8_t l=0;l<NUM_LANES;++l) g_laneSinkName[l] = "lcd-i80";   // reported in /status
+    return true;
+  }
+  Serial.println("[PAR] parallel output unavailable, using SPI lanes");
+  delete g_par; g_par = nullptr;
+  return false;
+}
+
 static void rebuildStrips(){
-  // Dispose old lanes
+  // Dispose old outputs (lanes and parallel engine share pins)
   for (uint8_t l=0;l<NUM_LANES;++l) {
     if (g_lanes[l]) { delete g_lanes[l]; g_lanes[l] = nullptr; }
   }
-  // Build new lanes (each drives 2 * pixelsPerArm)
+  if (g_par) { delete g_par; g_par = nullptr; }
+
   const uint16_t nPerArm = armPixelCount();
-  const uint16_t nPerLane = nPerArm * 2;
-  for (uint8_t l=0;l<NUM_LANES;++l) {
-    g_lanes[l] = new Adafruit_DotStar(nPerLane, LANE_DATA[l], LANE_CLK[l], DOTSTAR_BGR);
-    g_lanes[l]->begin();
-    g_lanes[l]->setBrightness(g_brightness);
-    g_lanes[l]->clear();
-    g_lanes[l]->show();
-  }
+  if (g_outputMode == OUT_PARALLEL && buildParallel(nPerArm)) {
+    refreshLaneLevels();
+    g_par->clear(); g_par->show();
+  } else {
+    // Build new lanes (each drives 2 * pixelsPerArm)
+    const uint16_t nPerLane = nPerArm * 2;
+    for (uint8_t l=0;l<NUM_LANES;++l) {
+      g_lanes[l] = new LaneOutput();
+      if (!g_lanes[l]->begin(new SpiDmaSink(LANE_SPI_HOST[l], LANE_DATA[l], LANE_CLK[l], LANE_SPI_HZ), nPerLane)) {
+        delete g_lanes[l];
+        g_lanes[l] = new LaneOutput();
+        if (!g_lanes[l]->begin(new GpioSink(LANE_DATA[l], LANE_CLK[l]), nPerLane)) {
+          Serial.printf("[LANE] lane %u: no output\n", (unsigned)l);
+          delete g_lanes[l]; g_lanes[l] = nullptr;
+          g_laneSinkName[l] = "none";
+          continue;
+        }
+      }
+      g_laneSinkName[l] = g_lanes[l]->sinkName();
+    }
 
-  // Route table: Arm1+Arm2 on Lane0 ; Arm3+Arm4 on Lane1
-  // Arm1 outside-fed (normal), Arm2 center-fed (reversed)
-  // Arm3 outside-fed (normal), Arm4 center-fed (reversed)
-  g_armRoute[0] = { 0, 0,           false };         // Arm1 → lane 0, offset 0, normal
-  g_armRoute[1] = { 0, nPerArm,     true  };         // Arm2 → lane 0, offset N, reversed
-  g_armRoute[2] = { 1, 0,           false };         // Arm3 → lane 1, offset 0, normal
-  g_armRoute[3] = { 1, nPerArm,     true  };         // Arm4 → lane 1, offset N, reversed
+    // Route table: Arm1+Arm2 on Lane0 ; Arm3+Arm4 on Lane1
+    // Arm1 outside-fed (normal), Arm2 center-fed (reversed)
+    // Arm3 outside-fed (normal), Arm4 center-fed (reversed)
+    g_armRoute[0] = { 0, 0,           false };         // Arm1 → lane 0, offset 0, normal
+    g_armRoute[1] = { 0, nPerArm,     true  };         // Arm2 → lane 0, offset N, reversed
+    g_armRoute[2] = { 1, 0,           false };         // Arm3 → lane 1, offset 0, normal
+    g_armRoute[3] = { 1, nPerArm,     true  };         // Arm4 → lane 1, offset N, reversed
+
+    refreshLaneLevels();
+    for (uint8_t l=0;l<NUM_LANES;++l) if (g_lanes[l]) { g_lanes[l]->clear(); g_lanes[l]->show(); }
+  }
 
   // Clear legacy arm state
   for (uint8_t a=0;a<MAX_ARMS;++a) strips[a] = nullptr;
@@ -820,25 +2133,26 @@ static void rebuildStrips(){
 
 /* -------------------- Arm runtime / blanking -------------------- */
 static void resetArmRuntimeStates(){
-  noInterrupts();
-  g_hallSyncPending = false;
-  g_hallSyncTimestampUs = 0;
-  interrupts();
   for (uint8_t a=0; a<MAX_ARMS; ++a) {
     g_armState[a].baseSpoke = 0;
     g_armState[a].currentSpoke = 0;
-    g_armState[a].blankDeadlineUs = 0;
-    g_armState[a].lit = false;
     g_lastPulseSpoke[a] = 0xFFFF;
   }
   g_spokeDurationUs = 0;
-  g_nextSpokeDeadlineUs = 0;
-  g_spokeStep = 0;
+  g_sched.reset();
+  g_angle.reset();
 }
 //Diagnostic to see which SPI Lane is being used for what arm
 static void handleLaneDiag() {
   g_playing = false; g_paused = false;
   g_hallDiagEnabled = false; g_armTestEnabled = false;
+  renderPost(RCMD_LANEDIAG);
+
+  server.send(200, "application/json", "{\"lanediag\":\"shown\"}");
+}
+
+// Render core side of RCMD_LANEDIAG
+static void showLaneDiag() {
   blackoutAll();
 
   const uint8_t arms = activeArmCount();
@@ -847,43 +2161,8 @@ static void handleLaneDiag() {
   if (arms >= 3) armFillColor(2,   0,   0, 255); // Arm3 = BLUE
   if (arms >= 4) armFillColor(3, 255, 255, 255); // Arm4 = WHITE
   lanesShowAll();
-
-  server.send(200, "application/json", "{\"lanediag\":\"shown\"}");
-}
-
-
-/* -------------------- Parallel helpers (unchanged behavior) -------------------- */
-static void configureParallelPins() {
-  if (g_parallelPinsInit) return;
-  g_clkMask1 = 0;
-  g_allDataMask1 = 0;
-  // No dedicated ARM_CLK/DATA used now; keep masks zeroed (safe no-op if parallel selected)
-  g_parallelPinsInit = true;
 }
 
-static IRAM_ATTR void sk9822_tx_parallel_spoke(uint16_t spokeIdx) {
-  // Fallback-safe using g_pixelsPerArm if no strip object
-  const uint16_t pixelCount = armPixelCount();
-  if (!spokesCount() || !pixelCount) return;
-
-  // Minimal parallel stub clocks (pins/masks are zero in this SPI build)
-  noInterrupts();
-  for (int k = 0; k < 32; ++k) { GPIO.out1_w1tc.val = g_allDataMask1; GPIO.out1_w1ts.val = g_clkMask1; clk_pad_delay(); GPIO.out1_w1tc.val = g_clkMask1; }
-  for (uint16_t i = 0; i < pixelCount; ++i) {
-    for (int bit = 0; bit < 32; ++bit) { GPIO.out1_w1tc.val = g_allDataMask1; GPIO.out1_w1ts.val = g_clkMask1; clk_pad_delay(); GPIO.out1_w1tc.val = g_clkMask1; }
-  }
-  for (int k = 0; k < 32; ++k) { GPIO.out1_w1tc.val = g_allDataMask1; GPIO.out1_w1ts.val = g_clkMask1; clk_pad_delay(); GPIO.out1_w1tc.val = g_clkMask1; }
-  interrupts();
-}
-
-static IRAM_ATTR void sk9822_tx_parallel_black() {
-  noInterrupts();
-  for (int k = 0; k < 32; ++k) { GPIO.out1_w1tc.val = g_allDataMask1; GPIO.out1_w1ts.val = g_clkMask1; clk_pad_delay(); GPIO.out1_w1tc.val = g_clkMask1; }
-  const uint16_t pixelCount  = armPixelCount();
-  const uint32_t bits = 32u * pixelCount + 32u;
-  for (uint32_t b = 0; b < bits; ++b) { GPIO.out1_w1tc.val = g_allDataMask1; GPIO.out1_w1ts.val = g_clkMask1; clk_pad_delay(); GPIO.out1_w1tc.val = g_clkMask1; }
-  interrupts();
-}
 
 /* -------------------- Draw / blank on SPI lanes -------------------- */
 static void blackoutAll(){
@@ -892,121 +2171,101 @@ static void blackoutAll(){
 }
 
 static void paintArmAt(uint8_t arm, uint16_t spokeIdx, uint32_t nowUs){
+  StageTimer st(MS_PAINT);
   if (arm >= MAX_ARMS) return;
 
-  // === Parallel fallback (unchanged) ===
-  if (g_outputMode == OUT_PARALLEL) {
-    if (arm == 0) {
-      configureParallelPins();
-      sk9822_tx_parallel_spoke(spokeIdx);
-      const uint8_t arms = activeArmCount();
-      const uint16_t sct = spokesCount();
-      for (uint8_t a = 0; a < arms; ++a) {
-        g_armState[a].currentSpoke = sct ? (spokeIdx % sct) : 0;
-        g_armState[a].lit = true;
-        g_armState[a].blankDeadlineUs = nowUs + ARM_BLANK_DELAY_US;
-        if (g_armState[a].blankDeadlineUs == 0) g_armState[a].blankDeadlineUs = 1;
-      }
-    }
-    return;
-  }
-
-  // === SPI (two-lane) path — indexing ===
+  // === Gather through the offset table (SPI lanes or parallel lines) ===
   const uint16_t spokes = spokesCount();
   const uint8_t  arms   = activeArmCount();
   const uint16_t pixelCount = armPixelCount();
+  const PixelLut* lut = g_pixLut;
+  const bool native = g_nativeSeq;
 
-  if (!g_frameValid || !g_frameBuf || g_fh.channelCount == 0 || arms == 0 || pixelCount == 0) {
+  if (!g_frameValid || !g_frameBuf || arms == 0 || pixelCount == 0 ||
+      (native ? (arm >= g_povHdr.arms || g_povHdr.arms != arms || g_povHdr.pixels != pixelCount)
+              : (!lut || arm >= lut->arms || lut->arms != arms || lut->pixels != pixelCount))) {
     blankArm(arm);
     return;
   }
 
-  // Many spinner FSEQ exports store ONE spoke per frame:
-  //   channelCount == arms * pixelsPerArm * 3
-  const uint32_t expectedPerSpoke = (uint32_t)arms * (uint32_t)pixelCount * 3u;
-  const bool perSpokeFrame = (g_fh.channelCount == expectedPerSpoke);
-
-  // Channels that belong to ONE spoke inside this frame
-  uint32_t chPerSpoke = expectedPerSpoke;
-  if (!perSpokeFrame) {
-    if (spokes > 0 && (g_fh.channelCount % spokes) == 0) {
-      chPerSpoke = g_fh.channelCount / spokes;
-    }
-  }
-
-  // Base (R) channel for THIS arm, pixel 0 (1-based → 0-based)
-  uint32_t baseChAbsR = 0;
-  if (g_usePerArmStart) {
-    baseChAbsR = (g_startChArm[arm] ? g_startChArm[arm]-1 : 0);
-  } else {
-    const uint32_t base = (g_startChArm1 ? g_startChArm1-1 : 0);
-    const uint32_t armBlockStride = (uint32_t)pixelCount * 3u;
-    baseChAbsR = base + (uint32_t)arm * armBlockStride;
-  }
-
-  // If a frame carries multiple spokes, add the spoke slice offset
-  if (!perSpokeFrame) {
-    const uint16_t s = (spokes ? spokes : 1);
-    baseChAbsR += ((uint32_t)(spokeIdx % s)) * chPerSpoke;
-  }
-
   if (spokes) spokeIdx %= spokes;
   g_armState[arm].currentSpoke = spokeIdx;
 
-  for (uint16_t i = 0; i < pixelCount; ++i) {
-    const uint32_t absR = baseChAbsR + (uint32_t)i * 3u;
-    const int64_t  idxR = sparseTranslate(absR);
-
-    uint8_t R=0,G=0,B=0;
-    if (idxR >= 0 && (idxR + 2) < (int64_t)g_fh.channelCount) {
-      mapChannels(&g_frameBuf[idxR], R, G, B);
-    }
-
-    if (g_brightness < 255) {
-      R = (uint8_t)((uint16_t)R * g_brightness / 255);
-      G = (uint8_t)((uint16_t)G * g_brightness / 255);
-      B = (uint8_t)((uint16_t)B * g_brightness / 255);
+  // Fast path: the producer already encoded this frame for the lanes
+  const SpokeWire* w = g_frameWire;
+  uint8_t* dst = armWords(arm, pixelCount);
+  if (native) {
+    // Native sequence: the frame is the wire, spoke-major
+    const uint16_t sl = (g_povHdr.slices > 1) ? (uint16_t)(spokeIdx % g_povHdr.slices) : 0;
+    const uint8_t* src = g_frameBuf + ((size_t)sl * arms + arm) * pixelCount * 4;
+    if (dst) {
+      if (g_renderLevelsId) memcpy(dst, src, (size_t)pixelCount * 4);
+      else polarApplyLevels(src, pixelCount, g_renderLvl, g_renderHdr, dst);
     }
-    armSetPixel(arm, i, R, G, B);
+    ++g_paintNative;
+  } else if (w && w->gen == __atomic_load_n(&g_encGen, __ATOMIC_ACQUIRE) && w->arms == arms && w->pixels == pixelCount && dst) {
+    const uint16_t sl = (w->slices > 1) ? (uint16_t)(spokeIdx % w->slices) : 0;
+    memcpy(dst, w->words + ((size_t)arm * w->slices + sl) * pixelCount * 4, (size_t)pixelCount * 4);
+    ++g_paintWire;
+  } else {
+    // Gather straight into the output buffer with the kernel picked for this arm
+    static int32_t row[MAX_PIXELS_PER_ARM];   // render core only
+    const uint16_t slice = (lut->slices > 1) ? (uint16_t)(spokeIdx % lut->slices) : 0;
+    if (dst && g_paintKernel[arm]) g_paintKernel[arm](g_frameBuf, lutRow(lut, arm, slice, row), pixelCount, g_renderLvl, g_renderHdr, dst);
+    ++g_paintGeneric;
   }
 
   armShow(arm);
-  g_armState[arm].lit = true;
-  g_armState[arm].blankDeadlineUs = nowUs + ARM_BLANK_DELAY_US;
-  if (g_armState[arm].blankDeadlineUs == 0) g_armState[arm].blankDeadlineUs = 1;
+  g_sched.lit(arm, nowUs, ARM_BLANK_DELAY_US);
 }
 
 
 static void processArmBlanking(uint32_t nowUs){
   const uint8_t arms = activeArmCount();
-  for (uint8_t a=0; a<arms; ++a){
-    if (!g_armState[a].lit) continue;
-    uint32_t blankAt = g_armState[a].blankDeadlineUs;
-    if (blankAt && microsReached(nowUs, blankAt)) {
-      blankArm(a);
-    }
-  }
-  for (uint8_t a=arms; a<MAX_ARMS; ++a){
-    if (g_armState[a].lit) blankArm(a);
+  const uint8_t due  = g_sched.blanksDue(nowUs);
+  for (uint8_t a=0; a<MAX_ARMS; ++a){
+    if (((due >> a) & 1) || (a >= arms && g_sched.isLit(a))) blankArm(a);
   }
 }
 
-static void processHallSyncEvent(uint32_t nowUs){
-  uint32_t syncUs = 0;
-  bool haveSync = false;
+// Render core: drain every captured edge (no interrupt masking).  Debounce
+// and pulses-per-rev counting happen here; each sync pulse is handed on.
+static void hallPulse(uint32_t t, uint32_t nowUs, bool schedule){
+  const uint32_t dt = t - g_lastPulseUsIsr;
+  g_lastPulseUsIsr = t;
+  if (dt <= 1000) return;              // crude debounce: pulses < 1ms apart are spurious
+  g_lastPeriodUs = dt;
+  g_pulseCount = g_pulseCount + 1;
+  const uint8_t ppr = g_pulsesPerRev ? g_pulsesPerRev : 1;
+  if ((g_pulseCount % ppr) == 0) processHallSyncEvent(t, nowUs, schedule);
+}
 
-  noInterrupts();
-  if (g_hallSyncPending) {
-    syncUs = g_hallSyncTimestampUs;
-    g_hallSyncPending = false;
-    haveSync = true;
+static void drainHallEdges(uint32_t nowUs, bool schedule){
+  uint32_t t;
+  while (g_hall.pop(t)) {
+    if (!g_sim.active()) hallPulse(t, nowUs, schedule);   // real edges are ignored while simulating
   }
-  interrupts();
-  if (!haveSync) return;
+  while (g_sim.due(nowUs, t)) hallPulse(t, nowUs, schedule);
+}
+
+// A Hall pulse (real or simulated) is waiting to be handled
+static inline bool hallPending(){
+  return g_hall.pending() || (g_sim.active() && usReached(micros(), g_sim.nextUs()));
+}
+
+// schedule=false (not playing): only the trace and the estimator see the sync
+static void processHallSyncEvent(uint32_t syncUs, uint32_t nowUs, bool schedule){
+  StageTimer st(MS_HALL_SYNC);
+  if (g_hallTraceOn && g_hallTrace && g_hallTraceLen < HALL_TRACE_MAX) g_hallTrace[g_hallTraceLen++] = syncUs;
 
   const uint16_t spokes = spokesCount();
   if (!spokes) return;
 
+  // Outlier (bounce, double or stray pulse): keep the running schedule
+  if (!g_angle.update(syncUs)) { ++g_hallSyncRejected; return; }
+  if (!schedule) return;
+
+  swapAtBoundary(0);
   const uint8_t arms = activeArmCount();
   const int startIdx0 = spoke1BasedToIdx0(START_SPOKE_1BASED, (int)spokes);
 
@@ -1018,54 +2277,98 @@ static void processHallSyncEvent(uint32_t nowUs){
     if (!g_strobeEnable) {
       paintArmAt(a, base, nowUs);
     } else {
-      if (g_armState[a].lit) blankArm(a);
+      if (g_sched.isLit(a)) blankArm(a);
       g_lastPulseSpoke[a] = 0xFFFF;
     }
   }
   for (uint8_t a = arms; a < MAX_ARMS; ++a){
     g_armState[a].baseSpoke = 0;
-    if (g_armState[a].lit) blankArm(a);
-  }
-
-  uint64_t revolutionUs = 0;
-  if (g_lastPeriodUs > 0) {
-    uint8_t ppr = g_pulsesPerRev ? g_pulsesPerRev : 1;
-    revolutionUs = (uint64_t)g_lastPeriodUs * (uint64_t)ppr;
-  } else if (g_spokeDurationUs > 0 && spokes > 0) {
-    revolutionUs = (uint64_t)g_spokeDurationUs * (uint64_t)spokes;
-  }
-  if (revolutionUs == 0) revolutionUs = 1000000ULL;
-
-  uint32_t newDur = (uint32_t)(revolutionUs / (uint64_t)spokes);
-  if (newDur == 0) newDur = 1;
-
-  uint32_t prev = g_spokeDurationUs;
-  if (prev > 0) {
-    newDur = (uint32_t)(((uint64_t)prev * 3ULL + newDur) / 4ULL);
+    if (g_sched.isLit(a)) blankArm(a);
+  }
+
+  // Spoke period for the coming revolution: the tracker's prediction (period
+  // plus half its change, so spin-up/down does not lag).  Until it has two
+  // syncs, fall back to the raw pulse period.
+  // The replay harness scores exactly this schedule (AngleEstimator::spokeTimeUs()).
+  uint32_t newDur = 0;
+  uint32_t anchorUs = syncUs;
+  if (g_angle.hasPeriod()) {
+    newDur = g_angle.spokeUs(spokes);
+    anchorUs = g_angle.syncUs();
+  } else {
+    uint64_t revolutionUs = 1000000ULL;
+    if (g_lastPeriodUs > 0) {
+      uint8_t ppr = g_pulsesPerRev ? g_pulsesPerRev : 1;
+      revolutionUs = (uint64_t)g_lastPeriodUs * (uint64_t)ppr;
+    }
+    newDur = (uint32_t)(revolutionUs / (uint64_t)spokes);
     if (newDur == 0) newDur = 1;
   }
 
   g_spokeDurationUs = newDur;
-  g_spokeStep = 0;
-  g_nextSpokeDeadlineUs = syncUs + g_spokeDurationUs;
-  if (g_nextSpokeDeadlineUs == 0) g_nextSpokeDeadlineUs = 1;
+  g_sched.sync(anchorUs, g_spokeDurationUs, spokes);
 }
 
-static void advancePredictedSpokes(uint32_t nowUs){
+static void paintSpokeStep(uint16_t step, uint32_t atUs){
   const uint16_t spokes = spokesCount();
   if (!spokes) return;
-  if (g_spokeDurationUs == 0 || g_nextSpokeDeadlineUs == 0) return;
-
+  if (step) swapAtBoundary(step);   // step 0 is drawn by the Hall sync
+  const uint32_t t0 = micros();
   const uint8_t arms = activeArmCount();
-  while (microsReached(nowUs, g_nextSpokeDeadlineUs)) {
-    g_spokeStep = (g_spokeStep + 1) % spokes;
-    for (uint8_t a=0; a<arms; ++a){
-      uint16_t base = g_armState[a].baseSpoke % spokes;
-      uint16_t spoke = (base + g_spokeStep) % spokes;
-      paintArmAt(a, spoke, nowUs);
-    }
-    g_nextSpokeDeadlineUs += g_spokeDurationUs;
+  for (uint8_t a=0; a<arms; ++a){
+    uint16_t base = g_armState[a].baseSpoke % spokes;
+    paintArmAt(a, (uint16_t)((base + step) % spokes), atUs);
   }
+  if (g_benchOn) g_benchPaintUs.add(micros() - t0);
+}
+
+// Only the latest due spoke is drawn; missed ones are counted by g_sched
+static void advancePredictedSpokes(uint32_t nowUs){
+  uint16_t step; uint32_t startUs;
+  if (!g_sched.spokeDue(nowUs, step, startUs)) return;
+  const bool ready = g_sched.isPrepared(step);   // drawn ahead; only the commit is left
+  g_sched.clearPrepared();
+  if (!ready) paintSpokeStep(step, nowUs);
+  g_benchSpokeStartUs = startUs;
+  g_benchSpokeOpen = true;
+}
+
+// After commitOutputs(): time from the fired spoke's start to its transfers queued
+static void benchSpokeCommitted(){
+  if (!g_benchSpokeOpen) return;
+  g_benchSpokeOpen = false;
+  if (!g_benchOn) return;
+  const uint32_t lat = micros() - g_benchSpokeStartUs;
+  g_benchSpokeUs.add(lat);
+  if (lat >= g_sched.spokeUs()) ++g_benchMissed;
+}
+
+// Render core side of RCMD_BENCH / RCMD_BENCH_STOP
+static void benchStart(BenchRequest* rq){
+  benchStop();
+  g_benchSpokeUs.reset(); g_benchPaintUs.reset(); g_benchLoadUs.reset();
+  g_benchMissed    = 0;
+  g_benchSkipBase  = g_sched.skipped();
+  g_benchSpokeOpen = false;
+  g_benchStartMs   = millis();
+  g_benchEndMs     = 0;
+  g_benchUntilMs   = (rq && rq->seconds) ? g_benchStartMs + rq->seconds * 1000UL : 0;
+  if (rq && rq->simulate) {
+    g_simTrace = (uint32_t*)rq->sim.trace;
+    resetArmRuntimeStates();           // lock onto the simulated rotor from scratch
+    g_sim.start(micros(), rq->sim);
+    Serial.printf("[BENCH] simulating %.0f rpm%s\n", rq->sim.rpm, g_simTrace ? " (trace)" : "");
+  }
+  delete rq;
+  g_benchOn = true;
+}
+
+static void benchStop(){
+  if (g_benchOn) g_benchEndMs = millis();
+  g_benchOn = false;
+  if (g_sim.active()) { g_sim.stop(); resetArmRuntimeStates(); }
+  free(g_simTrace);
+  g_simTrace = nullptr;
 }
 
 /* -------------------- Web: Files page + ops -------------------- */
@@ -1139,6 +2442,7 @@ static void handleStatus(){
   json += ",\"desiredMode\":" + String((unsigned)g_sdPreferredBusWidth);
   json += ",\"baseFreq\":" + String((unsigned long)g_sdBaseFreqKHz);
   json += ",\"freq\":" + String((unsigned long)g_sdFreqKHz);
+  json += ",\"bus\":" + sdBusJson();
   json += "}";
   json += ",\"hallDiag\":" + String(g_hallDiagEnabled ? "true" : "false");
   json += ",\"armTest\":" + String(g_armTestEnabled ? "true" : "false");
@@ -1150,11 +2454,59 @@ static void handleStatus(){
   json += ",\"strobe\":{\"enable\":" + String(g_strobeEnable ? "true" : "false") +
           ",\"deg\":" + String(g_strobeWidthDeg,2) +
           ",\"phase\":" + String(g_strobePhaseDeg,2) + "}";
+  json += ",\"gamma\":" + String(g_gammaX10 / 10.0f, 1);
   json += ",\"rpm\":" + String(computeRpmSnapshot());
   json += ",\"rpmPpr\":" + String((unsigned)g_pulsesPerRev);
   json += ",\"rpmEdge\":" + String((unsigned)g_hallEdgeMode);
   json += ",\"period_us\":" + String(g_lastPeriodUs);
+  json += ",\"ring\":{\"depth\":" + String((unsigned)g_ringDepth) +
+          ",\"fill\":" + String((unsigned long)ringFill()) +
+          ",\"highWater\":" + String((unsigned long)g_ringHighWater) +
+          ",\"underruns\":" + String((unsigned long)g_ringUnderruns) + "}";
+  json += ",\"paint\":{\"wire\":" + String((unsigned long)g_paintWire) +
+          ",\"native\":" + String((unsigned long)g_paintNative) +
+          ",\"generic\":" + String((unsigned long)g_paintGeneric) + "}";
+  json += ",\"frameClock\":{\"source\":\"" + String(g_fpsFromFile ? "file" : "fps") + "\"" +
+          ",\"periodUs\":" + String((double)g_frameClock.periodNum() / g_frameClock.periodDen(), 1) +
+          ",\"dropped\":" + String((unsigned long)g_framesDropped) + "}";
+  json += ",\"frameSwap\":{\"align\":" + String(g_swapAlign ? "true" : "false") +
+          ",\"spoke\":" + String((unsigned)g_swapStep) +
+          ",\"deferred\":" + String((unsigned long)g_swapsDeferred) +
+          ",\"aligned\":" + String((unsigned long)g_swapsAligned) +
+          ",\"forced\":" + String((unsigned long)g_swapsForced) +
+          ",\"immediate\":" + String((unsigned long)g_swapsImmediate) + "}";
+  json += ",\"hallSync\":{\"rejected\":" + String((unsigned long)g_hallSyncRejected) +
+          ",\"trace\":" + String((unsigned long)g_hallTraceLen) + "}";
+  json += ",\"hallCapture\":{\"source\":\"" + String(g_hall.source()) + "\"" +
+          ",\"dropped\":" + String((unsigned long)g_hall.dropped()) + "}";
+  json += ",\"sched\":{\"timer\":" + String(g_spokeTimer ? "true" : "false") +
+          ",\"wakeups\":" + String((unsigned long)g_schedWakeups) +
+          ",\"lateUsLast\":" + String((unsigned long)g_schedLateUsLast) +
+          ",\"lateUsMax\":" + String((unsigned long)g_schedLateUsMax) +
+          ",\"skipped\":" + String((unsigned long)g_sched.skipped()) + "}";
+  json += ",\"decode\":{\"codec\":\"" + String(codecName(g_fh.compType)) + "\"" +
+          ",\"perFrame\":" + String(g_compPerFrame ? "true" : "false") +
+          ",\"lastUs\":" + String((unsigned long)g_decodeUsLast) +
+          ",\"avgUs\":" + String((unsigned long)(g_loadCount ? g_decodeUsSum / g_loadCount : 0)) +
+          ",\"loadLastUs\":" + String((unsigned long)g_loadUsLast) +
+          ",\"loadAvgUs\":" + String((unsigned long)(g_loadCount ? g_loadUsSum / g_loadCount : 0)) +
+          ",\"frames\":" + String((unsigned long)g_loadCount) + "}";
+  json += ",\"blockCache\":{\"slots\":" + String((unsigned)g_blockCacheSlots) +
+          ",\"blockFrames\":" + String((unsigned long)g_blockFrames) +
+          ",\"hits\":" + String((unsigned long)g_blockHits) +
+          ",\"misses\":" + String((unsigned long)g_blockMisses) + "}";
+  json += ",\"seqCache\":" + seqCacheJson();
+  json += ",\"transcode\":" + transcodeJson();
+  json += ",\"readAhead\":{\"kB\":" + String((unsigned long)(g_raCap >> 10)) +
+          ",\"fills\":" + String((unsigned long)g_raFills) +
+          ",\"hits\":" + String((unsigned long)g_raHits) +
+          ",\"fillUsLast\":" + String((unsigned long)g_raFillUsLast) +
+          ",\"MBps\":" + String(g_raFillUsSum ? (double)g_raBytes / (double)g_raFillUsSum : 0.0, 2) + "}";
   json += ",\"outmode\":\""; json += (g_outputMode==OUT_PARALLEL?"parallel":"spi"); json += "\"";
+  json += ",\"laneSink\":[\"" + String(g_laneSinkName[0]) + "\",\"" + String(g_laneSinkName[1]) + "\"]";
+  json += ",\"laneTx\":{\"shows\":[" + String((unsigned long)g_laneTxShows[0]) + "," + String((unsigned long)g_laneTxShows[1]) +
+          "],\"partial\":[" + String((unsigned long)g_laneTxPartial[0]) + "," + String((unsigned long)g_laneTxPartial[1]) +
+          "],\"kB\":[" + String((unsigned long)(g_laneTxBytes[0] >> 10)) + "," + String((unsigned long)(g_laneTxBytes[1] >> 10)) + "]}";
   json += ",\"map\":{\"usePerArm\":" + String(g_usePerArmStart ? "true":"false") +
           ",\"start\":" + String(g_startChArm1) +
           ",\"start2\":" + String(g_startChArm[1]) +
@@ -1196,7 +2548,8 @@ static void handleRoot() {
 static void applyBrightness(uint8_t pct){
   if (pct>100) pct=100;
   g_brightnessPercent=pct; g_brightness=(uint8_t)((255*pct)/100);
-  for (uint8_t l=0; l<NUM_LANES; ++l) if (g_lanes[l]) { g_lanes[l]->setBrightness(g_brightness); g_lanes[l]->show(); }
+  __atomic_add_fetch(&g_encGen, 1, __ATOMIC_RELEASE);   // queued frames were encoded at the old level
+  renderPost(RCMD_BRIGHTNESS);
   prefs.putUChar("brightness", g_brightnessPercent);
   persistSettingsToSd();
 }
@@ -1227,7 +2580,7 @@ static void handleStart(){
     g_armTestCurrentPixel = 0;
     g_armTestNextStepMs = 0;
   }
-  g_playing=true; g_paused=false; g_lastTickMs=millis();
+  g_playing=true; g_paused=false; g_clockRestart=true;
   g_bootMs = millis();
   server.send(200,"application/json","{\"playing\":true}");
 }
@@ -1237,7 +2590,7 @@ static void handleStop(){
   g_bgEffectActive = false;
   g_bootMs = millis();
   g_bgEffectNextAttemptMs = g_bootMs;
-  blackoutAll();
+  renderPost(RCMD_BLACKOUT);
   server.send(200,"application/json","{\"playing\":false}");
 }
 
@@ -1277,7 +2630,7 @@ static void handlePause(){
   if (!toggle) g_paused = wantPause && g_playing;
   else g_paused = !g_paused && g_playing;
 
-  if (!g_paused) g_lastTickMs = millis();
+  if (!g_paused) g_clockRestart = true;   // resume without catching up on the pause
 
   server.send(200,"application/json",
               String("{\"paused\":") + (g_paused ? "true" : "false") +
@@ -1308,7 +2661,7 @@ static void handleHallDiag(){
       g_bootMs = millis();
       g_bgEffectNextAttemptMs = g_bootMs;
       g_hallDiagActive = false;
-      blackoutAll();
+      renderPost(RCMD_BLACKOUT);
     }
   } else {
     if (g_hallDiagEnabled) {
@@ -1316,7 +2669,7 @@ static void handleHallDiag(){
       g_hallDiagActive = false;
       g_bootMs = millis();
       g_bgEffectNextAttemptMs = g_bootMs;
-      blackoutAll();
+      renderPost(RCMD_BLACKOUT);
     }
   }
 
@@ -1349,7 +2702,7 @@ static void handleArmTest(){
         g_hallDiagEnabled = false;
         g_hallDiagActive = false;
       }
-      blackoutAll();
+      renderPost(RCMD_BLACKOUT);
     }
   } else {
     if (g_armTestEnabled) {
@@ -1360,7 +2713,7 @@ static void handleArmTest(){
       g_armTestNextStepMs = 0;
       g_bootMs = millis();
       g_bgEffectNextAttemptMs = g_bootMs;
-      blackoutAll();
+      renderPost(RCMD_BLACKOUT);
     }
   }
 
@@ -1368,18 +2721,81 @@ static void handleArmTest(){
               String("{\"armTest\":") + (g_armTestEnabled ? "true" : "false") + "}");
 }
 
+// /seqcache?budgetKB=2048 (0 = off).  Entries over the new budget are evicted
+// now; the sequence on air keeps its entry until the next open.
+static void handleSeqCache() {
+  if (server.hasArg("budgetKB")) {
+    g_seqBudgetKB = (uint16_t)clampI32(server.arg("budgetKB").toInt(), 0, 16384);
+    prefs.putUShort("sqbudget", g_seqBudgetKB);
+    seqCacheMakeRoom(0);
+  }
+  server.send(200, "application/json", seqCacheJson());
+}
+
+// /transcode: spinner-native conversion of the open sequence.  Runs by itself
+// once per file + mapping (auto=1); action=start forces a rebuild, cancel drops it.
+static void handleTranscode() {
+  if (server.method() == HTTP_POST) {
+    if (server.hasArg("auto")) {
+      g_povAuto = parseBoolArg(server.arg("auto"));
+      prefs.putBool("povauto", g_povAuto);
+    }
+    const String action = server.hasArg("action") ? server.arg("action") : "";
+    if (action == "start" || action == "cancel") {
+      const bool run = g_prefetchRun;
+      stopPrefetch();
+      bool ok = true;
+      if (action == "cancel") polarJobAbort("cancelled");
+      else ok = polarJobStart();
+      g_prefetchRun = run;
+      if (run && g_prefetchTask) xTaskNotifyGive(g_prefetchTask);
+      if (!ok) { server.send(409, "application/json", String("{\"error\":\"") + g_pov.lastError + "\"}"); return; }
+    } else if (action.length()) {
+      server.send(400, "application/json", "{\"error\":\"action must be start|cancel\"}");
+      return;
+    }
+  }
+  server.send(200, "application/json", transcodeJson());
+}
+
+// /frameswap?align=1&spoke=0&timeoutMs=250: where frame swaps happen.
+// spoke = spoke step after the Hall sync (0 = at the sync).
+static void handleFrameSwap() {
+  if (server.hasArg("align"))     g_swapAlign     = parseBoolArg(server.arg("align"));
+  if (server.hasArg("spoke"))     g_swapStep      = (uint16_t)clampI32(server.arg("spoke").toInt(), 0, (int32_t)spokesCount() - 1);
+  if (server.hasArg("timeoutMs")) g_swapTimeoutMs = (uint16_t)clampI32(server.arg("timeoutMs").toInt(), 10, 5000);
+  prefs.putBool("swalign", g_swapAlign);
+  prefs.putUShort("swspoke", g_swapStep);
+  prefs.putUShort("swto", g_swapTimeoutMs);
+  server.send(200, "application/json", String("{\"align\":") + (g_swapAlign ? "true" : "false") +
+              ",\"spoke\":" + g_swapStep + ",\"timeoutMs\":" + g_swapTimeoutMs + "}");
+}
+
+// /speed?fps=N overrides the file's frame rate; /speed?source=file follows it again
 static void handleSpeed() {
-  if (!server.hasArg("fps")) { server.send(400, "text/plain", "missing fps"); return; }
-  int val = server.arg("fps").toInt();
-  if (val < 1) val = 1;
-  if (val > 120) val = 120;
-  g_fps = (uint16_t)val;
-  g_framePeriodMs = (uint32_t) (1000UL / g_fps);
-  prefs.putUShort("fps", g_fps);
-  persistSettingsToSd();
-  g_lastTickMs = millis();
-  Serial.printf("[PLAY] FPS=%u  period=%lums\n", g_fps, (unsigned long)g_framePeriodMs);
-  server.send(200, "application/json", String("{\"fps\":") + g_fps + "}");
+  if (!server.hasArg("fps") && !server.hasArg("source")) { server.send(400, "text/plain", "missing fps or source"); return; }
+  if (server.hasArg("fps")) {
+    int val = server.arg("fps").toInt();
+    if (val < 1) val = 1;
+    if (val > 120) val = 120;
+    g_fps = (uint16_t)val;
+    g_fpsFromFile = false;
+    prefs.putUShort("fps", g_fps);
+    persistSettingsToSd();
+  }
+  if (server.hasArg("source")) {
+    String src = server.arg("source"); src.toLowerCase();
+    if (src == "file") g_fpsFromFile = true;
+    else if (src == "fps") g_fpsFromFile = false;
+    else { server.send(400, "text/plain", "source must be file|fps"); return; }
+  }
+  prefs.putBool("fpsfile", g_fpsFromFile);
+  g_clockRestart = true;
+  Serial.printf("[PLAY] rate: %s (fps=%u, file step=%ums)\n", g_fpsFromFile ? "file" : "override",
+                g_fps, (unsigned)g_fh.stepTimeMs);
+  server.send(200, "application/json", String("{\"fps\":") + g_fps +
+              ",\"source\":\"" + (g_fpsFromFile ? "file" : "fps") + "\"" +
+              ",\"stepMs\":" + (int)g_fh.stepTimeMs + "}");
 }
 
 static void handleMapCfg(){
@@ -1430,7 +2846,11 @@ static void handleMapCfg(){
     computeDefaultArmStarts(g_startChArm1);
   }
 
-  if (needRebuild) rebuildStrips();
+  if (needRebuild) {
+    renderPost(RCMD_REBUILD);
+    renderSync();      // routes (arm reversal) feed the table and the mapping hash
+  }
+  publishPixelLut();   // start channels / spokes / geometry all feed the offset table
 
   persistSettingsToSd();
 
@@ -1545,7 +2965,7 @@ static void handleBgEffect(){
     if (g_bgEffectActive) {
       g_playing = false; g_paused = false; g_bgEffectActive = false;
       g_bootMs = millis();
-      for (uint8_t a=0; a<activeArmCount(); ++a) armClear(a);
+      renderPost(RCMD_BLACKOUT);
     }
     g_bgEffectNextAttemptMs = millis();
   } else {
@@ -1596,8 +3016,343 @@ static void handleCBlocks(){
   server.send(200,"application/json",s);
 }
 
+// Random access: the producer is parked, queued frames are dropped on the render
+// core, then loading restarts at the target.  O(1) for raw and per-frame zlib.
+static bool seekFrame(uint32_t target){
+  const bool run = g_prefetchRun;
+  stopPrefetch();
+  if (!renderPost(RCMD_RING_FLUSH) || !renderSync()) {
+    g_prefetchRun = run;
+    if (run && g_prefetchTask) xTaskNotifyGive(g_prefetchTask);
+    return false;
+  }
+  g_prefetchNext   = target;
+  g_prefetchFailed = false;
+  g_prefetchRun    = true;
+  if (g_prefetchTask) xTaskNotifyGive(g_prefetchTask);
+  return true;
+}
+
+static void handleSeek(){
+  if (!g_fseq || !g_fh.frameCount || !g_ringDepth) { server.send(409,"application/json","{\"error\":\"no file\"}"); return; }
+  uint32_t target;
+  if (server.hasArg("frame"))   target = (uint32_t)clampI32(server.arg("frame").toInt(), 0, INT32_MAX);
+  else if (server.hasArg("ms")) target = (uint32_t)clampI32(server.arg("ms").toInt(), 0, INT32_MAX) / (g_fh.stepTimeMs ? g_fh.stepTimeMs : 1);
+  else { server.send(400,"application/json","{\"error\":\"frame or ms required\"}"); return; }
+  if (target >= g_fh.frameCount) target = g_fh.frameCount - 1;
+
+  if (!seekFrame(target)) {
+    server.send(503,"application/json","{\"error\":\"render busy\"}");
+    return;
+  }
+
+  server.send(200,"application/json",
+    String("{\"ok\":true,\"frame\":")+target+",\"ms\":"+(uint32_t)((uint64_t)target*g_fh.stepTimeMs)+"}");
+}
+
+// Times the configured template kernel against the per-pixel reference on a
+// synthetic spoke and checks both produce the same bytes.
+// /bench/kernels?iters=2000&sparse=0&rev=0
+static void handleBenchKernels() {
+  const uint16_t n = armPixelCount();
+  const uint32_t iters = server.hasArg("iters") ? (uint32_t)clampI32(server.arg("iters").toInt(), 1, 100000) : 2000;
+  const bool sparse = server.hasArg("sparse") && parseBoolArg(server.arg("sparse"));
+  const bool rev    = server.hasArg("rev") && parseBoolArg(server.arg("rev"));
+
+  uint8_t* frame = (uint8_t*)malloc((size_t)n * 3);
+  int32_t* offs  = (int32_t*)malloc((size_t)n * sizeof(int32_t));
+  uint8_t* ref   = (uint8_t*)malloc((size_t)n * 4);
+  uint8_t* out   = (uint8_t*)malloc((size_t)n * 4);
+  if (!frame || !offs || !ref || !out) {
+    free(frame); free(offs); free(ref); free(out);
+    server.send(500, "application/json", "{\"error\":\"oom\"}");
+    return;
+  }
+  uint32_t x = 0x9E3779B9u;
+  for (size_t i = 0; i < (size_t)n * 3; ++i) { x ^= x << 13; x ^= x >> 17; x ^= x << 5; frame[i] = (uint8_t)x; }
+  for (uint16_t i = 0; i < n; ++i) offs[i] = (sparse && (i % 7) == 3) ? -1 : (int32_t)i * 3;
+
+  uint8_t lvl[256], hdr;
+  computeLevels(g_brightness, g_gammaX10, lvl, hdr);
+  const bool levels = !levelsAreIdentity(lvl, hdr);
+  const SpokeKernel k = pickSpokeKernel(g_colorMap, sparse, levels, rev);
+
+  uint32_t t0 = micros();
+  for (uint32_t it = 0; it < iters; ++it) spokeKernelGeneric(g_colorMap, rev, frame, offs, n, lvl, hdr, ref);
+  const uint32_t genericUs = micros() - t0;
+  t0 = micros();
+  for (uint32_t it = 0; it < iters; ++it) k(frame, offs, n, lvl, hdr, out);
+  const uint32_t kernelUs = micros() - t0;
+  const bool match = memcmp(ref, out, (size_t)n * 4) == 0;
+  free(frame); free(offs); free(ref); free(out);
+
+  String j = String("{\"pixels\":") + n + ",\"iters\":" + iters +
+             ",\"sparse\":" + (sparse ? "true" : "false") + ",\"levels\":" + (levels ? "true" : "false") +
+             ",\"rev\":" + (rev ? "true" : "false") +
+             ",\"genericNsPerSpoke\":" + String((unsigned long)((uint64_t)genericUs * 1000 / iters)) +
+             ",\"kernelNsPerSpoke\":" + String((unsigned long)((uint64_t)kernelUs * 1000 / iters)) +
+             ",\"speedup\":" + String(kernelUs ? (float)genericUs / (float)kernelUs : 0.0f, 2) +
+             ",\"match\":" + (match ? "true" : "false") + "}";
+  server.send(200, "application/json", j);
+}
+
+/* -------------------- Hall trace record / replay -------------------- */
+static String hallTracePath() {
+  String p = server.hasArg("path") ? server.arg("path") : String("/hall_trace.bin");
+  if (!p.startsWith("/")) p = "/" + p;
+  return p;
+}
+
+static void handleHallTrace() {
+  String action = server.hasArg("action") ? server.arg("action") : String("");
+  action.toLowerCase();
+  if (action == "start") {
+    if (!g_hallTrace) g_hallTrace = (uint32_t*)allocFrameMem(HALL_TRACE_MAX * sizeof(uint32_t));
+    if (!g_hallTrace) { server.send(500, "application/json", "{\"error\":\"oom\"}"); return; }
+    g_hallTraceOn = false;
+    renderSync();
+    g_hallTraceLen = 0;
+    g_hallTraceOn = true;
+  } else if (action == "stop") {
+    g_hallTraceOn = false;
+    renderSync();
+  } else if (action == "save") {
+    g_hallTraceOn = false;
+    renderSync();
+    if (!g_hallTrace || !g_hallTraceLen) { server.send(409, "application/json", "{\"error\":\"no trace\"}"); return; }
+    const String path = hallTracePath();
+    if (!g_sdMutex || !SD_LOCK(pdMS_TO_TICKS(2000))) { server.send(503, "application/json", "{\"error\":\"sd busy\"}"); return; }
+    File f = SD_MMC.open(path, FILE_WRITE);
+    const size_t bytes = (size_t)g_hallTraceLen * sizeof(uint32_t);
+    const bool ok = f && f.write((const uint8_t*)g_hallTrace, bytes) == bytes;
+    if (f) f.close();
+    SD_UNLOCK();
+    if (!ok) { server.send(500, "application/json", "{\"error\":\"write failed\"}"); return; }
+  } else {
+    server.send(400, "application/json", "{\"error\":\"action must be start|stop|save\"}");
+    return;
+  }
+  server.send(200, "application/json", String("{\"recording\":") + (g_hallTraceOn ? "true" : "false") +
+              ",\"syncs\":" + String((unsigned long)g_hallTraceLen) + "}");
+}
+
+static String replayStatsJson(const ReplayStats& r) {
+  return String("{\"meanAbsDeg\":") + String(r.meanAbsDeg, 3) + ",\"rmsDeg\":" + String(r.rmsDeg, 3) +
+         ",\"maxAbsDeg\":" + String(r.maxAbsDeg, 3) + ",\"rejected\":" + String((unsigned long)r.rejected) + "}";
+}
+
+// Recorded trace (little-endian uint32 sync times) into a new buffer; caller frees
+static uint32_t* readHallTrace(const String& path, size_t& n) {
+  n = 0;
+  if (!g_sdMutex || !SD_LOCK(pdMS_TO_TICKS(2000))) return nullptr;
+  File f = SD_MMC.open(path, FILE_READ);
+  size_t cnt = f ? (size_t)(f.size() / sizeof(uint32_t)) : 0;
+  if (cnt > HALL_TRACE_MAX * 4) cnt = HALL_TRACE_MAX * 4;
+  uint32_t* ts = cnt ? (uint32_t*)allocFrameMem(cnt * sizeof(uint32_t)) : nullptr;
+  const bool ok = ts && f.read((uint8_t*)ts, cnt * sizeof(uint32_t)) == cnt * sizeof(uint32_t);
+  if (f) f.close();
+  SD_UNLOCK();
+  if (!ok) { free(ts); return nullptr; }
+  n = cnt;
+  return ts;
+}
+
+// Runs the estimator and the old EMA over a recorded trace (little-endian
+// uint32 sync times) and reports the angular error per spoke of each
+static void handleHallReplay() {
+  const String path = hallTracePath();
+  const uint16_t spokes = server.hasArg("spokes") ? (uint16_t)clampI32(server.arg("spokes").toInt(), 1, 1024) : spokesCount();
+  AngleEstimatorCfg cfg;
+  if (server.hasArg("alpha"))  cfg.alpha      = server.arg("alpha").toFloat();
+  if (server.hasArg("beta"))   cfg.beta       = server.arg("beta").toFloat();
+  if (server.hasArg("gamma"))  cfg.gamma      = server.arg("gamma").toFloat();
+  if (server.hasArg("reject")) cfg.rejectFrac = server.arg("reject").toFloat();
+
+  size_t n = 0;
+  uint32_t* ts = readHallTrace(path, n);
+  if (!ts) { server.send(404, "application/json", "{\"error\":\"cannot read trace\"}"); return; }
+
+  ReplayStats est, legacy;
+  const uint32_t t0 = micros();
+  replayHallTrace(ts, n, spokes, cfg, est, legacy);
+  const uint32_t us = micros() - t0;
+  free(ts);
+
+  String j = String("{\"syncs\":") + String((unsigned long)n) + ",\"spokes\":" + spokes +
+             ",\"revs\":" + String((unsigned long)est.revs) + ",\"replayUs\":" + String((unsigned long)us) +
+             ",\"estimator\":" + replayStatsJson(est) + ",\"legacyEma\":" + replayStatsJson(legacy) + "}";
+  server.send(200, "application/json", j);
+}
+
+// Prometheus text exposition of the stage histograms plus a few counters.
+// Quantiles come from log2 buckets, so they are upper bounds within 2x.
+static void appendMetric(String& out, const char* name, const String& labels, double v, uint8_t digits) {
+  out += name;
+  if (labels.length()) { out += "{"; out += labels; out += "}"; }
+  out += " ";
+  out += String(v, digits);
+  out += "\n";
+}
+
+static void handleMetrics() {
+  const double cyc2s = 1.0 / ((double)getCpuFrequencyMhz() * 1e6);
+  String m;
+  m.reserve(4096);
+  m += "# HELP lpov_stage_seconds Playback pipeline stage duration (CPU cycle counter, log2 buckets).\n"
+       "# TYPE lpov_stage_seconds summary\n";
+  for (uint8_t i = 0; i < MS_COUNT; ++i) {
+    const CycleHist& h = g_stageCycles[i];
+    const String st = String("stage=\"") + METRIC_STAGE_NAME[i] + "\"";
+    appendMetric(m, "lpov_stage_seconds", st + ",quantile=\"0.5\"",  h.percentile(50) * cyc2s, 9);
+    appendMetric(m, "lpov_stage_seconds", st + ",quantile=\"0.99\"", h.percentile(99) * cyc2s, 9);
+    appendMetric(m, "lpov_stage_seconds_sum", st, (double)h.sum() * cyc2s, 9);
+    appendMetric(m, "lpov_stage_seconds_count", st, (double)h.count(), 0);
+  }
+  m += "# TYPE lpov_stage_min_seconds gauge\n";
+  for (uint8_t i = 0; i < MS_COUNT; ++i)
+    appendMetric(m, "lpov_stage_min_seconds", String("stage=\"") + METRIC_STAGE_NAME[i] + "\"", g_stageCycles[i].min() * cyc2s, 9);
+  m += "# TYPE lpov_stage_max_seconds gauge\n";
+  for (uint8_t i = 0; i < MS_COUNT; ++i)
+    appendMetric(m, "lpov_stage_max_seconds", String("stage=\"") + METRIC_STAGE_NAME[i] + "\"", g_stageCycles[i].max() * cyc2s, 9);
+
+  m += "# TYPE lpov_rpm gauge\n";
+  appendMetric(m, "lpov_rpm", "", (double)g_rpmUi, 0);
+  m += "# TYPE lpov_playing gauge\n";
+  appendMetric(m, "lpov_playing", "", (g_playing && !g_paused) ? 1 : 0, 0);
+  m += "# TYPE lpov_frames_loaded gauge\n";
+  appendMetric(m, "lpov_frames_loaded", "", (double)g_loadCount, 0);
+  m += "# TYPE lpov_ring_underruns gauge\n";
+  appendMetric(m, "lpov_ring_underruns", "", (double)g_ringUnderruns, 0);
+  m += "# TYPE lpov_frames_dropped_total counter\n";
+  appendMetric(m, "lpov_frames_dropped_total", "", (double)g_framesDropped, 0);
+  m += "# TYPE lpov_frame_swaps_deferred_total counter\n";
+  appendMetric(m, "lpov_frame_swaps_deferred_total", "", (double)g_swapsDeferred, 0);
+  m += "# TYPE lpov_frame_swaps_total counter\n";
+  appendMetric(m, "lpov_frame_swaps_total", "kind=\"aligned\"",   (double)g_swapsAligned, 0);
+  appendMetric(m, "lpov_frame_swaps_total", "kind=\"forced\"",    (double)g_swapsForced, 0);
+  appendMetric(m, "lpov_frame_swaps_total", "kind=\"immediate\"", (double)g_swapsImmediate, 0);
+  m += "# TYPE lpov_spokes_skipped_total counter\n";
+  appendMetric(m, "lpov_spokes_skipped_total", "", (double)g_sched.skipped(), 0);
+  m += "# TYPE lpov_hall_rejected_total counter\n";
+  appendMetric(m, "lpov_hall_rejected_total", "", (double)g_hallSyncRejected, 0);
+  m += "# TYPE lpov_hall_dropped_total counter\n";
+  appendMetric(m, "lpov_hall_dropped_total", "", (double)g_hall.dropped(), 0);
+  m += "# TYPE lpov_lane_tx_bytes_total counter\n";
+  for (uint8_t l = 0; l < NUM_LANES; ++l)
+    appendMetric(m, "lpov_lane_tx_bytes_total", String("lane=\"") + l + "\"", (double)g_laneTxBytes[l], 0);
+  server.send(200, "text/plain; version=0.0.4", m);
+}
+
+static String seqCacheJson() {
+  uint8_t entries = 0;
+  for (uint8_t i=0; i<SEQ_CACHE_MAX; ++i) if (g_seqCache[i].data) ++entries;
+  return String("{\"budgetKB\":") + String((unsigned)g_seqBudgetKB) +
+         ",\"usedKB\":" + String((unsigned long)(seqCacheUsed() >> 10)) +
+         ",\"entries\":" + String((unsigned)entries) +
+         ",\"hits\":" + String((unsigned long)g_seqHits) +
+         ",\"stores\":" + String((unsigned long)g_seqStores) +
+         ",\"evictions\":" + String((unsigned long)g_seqEvictions) +
+         ",\"current\":" + (g_seqCur ? String("{\"loaded\":") + String((unsigned long)g_seqCur->loaded) +
+                                          ",\"frames\":" + String((unsigned long)g_seqCur->frames) + "}"
+                                       : String("null")) + "}";
+}
+
+static String transcodeJson() {
+  return String("{\"native\":") + (g_nativeSeq ? "true" : "false") +
+         ",\"auto\":" + (g_povAuto ? "true" : "false") +
+         ",\"active\":" + (g_pov.active ? "true" : "false") +
+         ",\"frame\":" + String((unsigned long)g_pov.next) +
+         ",\"frames\":" + String((unsigned long)(g_pov.active ? g_pov.hdr.frameCount : 0)) +
+         ",\"readKB\":" + String((unsigned long)(g_pov.readBytes / 1024)) +
+         ",\"done\":" + String((unsigned long)g_pov.done) +
+         ",\"aborted\":" + String((unsigned long)g_pov.aborted) +
+         ",\"lastMs\":" + String((unsigned long)g_pov.lastMs) +
+         ",\"lastError\":\"" + g_pov.lastError + "\"}";
+}
+
+static String histJson(const LatencyHist& h) {
+  String j = String("{\"n\":") + String((unsigned long)h.count()) +
+             ",\"mean\":" + String((unsigned long)h.mean()) +
+             ",\"p50\":" + String((unsigned long)h.percentile(50)) +
+             ",\"p99\":" + String((unsigned long)h.percentile(99)) +
+             ",\"max\":" + String((unsigned long)h.max()) + ",\"buckets\":[";
+  bool first = true;
+  for (uint8_t i = 0; i < LatencyHist::BUCKETS; ++i) {
+    if (!h.bucket(i)) continue;
+    if (!first) j += ",";
+    first = false;
+    j += "[" + String((unsigned long)LatencyHist::upper(i)) + "," + String((unsigned long)h.bucket(i)) + "]";
+  }
+  return j + "]}";
+}
+
+// POST /bench?action=start&rpm=600[&rpmEnd=1200&rampMs=5000][&jitter=50][&drop=0][&path=/hall.bin][&seconds=10]
+//   Times the live render path into histograms.  rpm or path simulates the rotor
+//   (real Hall edges ignored) so it runs with the spinner standing still;
+//   without them the real rotor is measured.  Spokes are only drawn while a
+//   sequence plays; spokes / pixels per arm are the live /mapcfg settings.
+//   action=stop ends it.
+// GET /bench: results.  Buckets are [upper bound (exclusive, us), count].
+static void handleBench() {
+  if (server.method() == HTTP_POST) {
+    String action = server.hasArg("action") ? server.arg("action") : String("");
+    action.toLowerCase();
+    if (action == "stop") {
+      renderPost(RCMD_BENCH_STOP);
+      renderSync();
+    } else if (action == "start") {
+      BenchRequest* rq = new BenchRequest();
+      rq->seconds  = server.hasArg("seconds") ? (uint32_t)clampI32(server.arg("seconds").toInt(), 0, 3600) : 0;
+      rq->sim.ppr  = g_pulsesPerRev ? g_pulsesPerRev : 1;
+      if (server.hasArg("rpm")) {
+        rq->simulate     = true;
+        rq->sim.rpm      = (float)clampI32(server.arg("rpm").toInt(), 30, 6000);
+        rq->sim.rpmEnd   = server.hasArg("rpmEnd") ? (float)clampI32(server.arg("rpmEnd").toInt(), 30, 6000) : 0.0f;
+        rq->sim.rampMs   = server.hasArg("rampMs") ? (uint32_t)clampI32(server.arg("rampMs").toInt(), 0, 600000) : 0;
+        rq->sim.jitterUs = server.hasArg("jitter") ? (uint32_t)clampI32(server.arg("jitter").toInt(), 0, 100000) : 0;
+        rq->sim.dropEvery = server.hasArg("drop") ? (uint8_t)clampI32(server.arg("drop").toInt(), 0, 255) : 0;
+      }
+      if (server.hasArg("path")) {
+        size_t n = 0;
+        uint32_t* ts = readHallTrace(hallTracePath(), n);
+        if (!ts || n < 2) { free(ts); delete rq; server.send(404, "application/json", "{\"error\":\"cannot read trace\"}"); return; }
+        rq->simulate     = true;
+        rq->sim.trace    = ts;
+        rq->sim.traceLen = (uint32_t)n;
+      }
+      if (!renderPost(RCMD_BENCH, rq)) {
+        free((void*)rq->sim.trace);
+        delete rq;
+        server.send(503, "application/json", "{\"error\":\"render busy\"}");
+        return;
+      }
+      renderSync();
+    } else {
+      server.send(400, "application/json", "{\"error\":\"action must be start|stop\"}");
+      return;
+    }
+  }
+
+  const uint32_t endMs = g_benchOn ? millis() : g_benchEndMs;
+  String j = String("{\"running\":") + (g_benchOn ? "true" : "false") +
+             ",\"ms\":" + String((unsigned long)(g_benchStartMs && endMs ? endMs - g_benchStartMs : 0)) +
+             ",\"sim\":{\"active\":" + (g_sim.active() ? "true" : "false") +
+             ",\"rpm\":" + String(g_sim.rpm(), 1) + ",\"pulses\":" + String((unsigned long)g_sim.pulses()) + "}" +
+             ",\"spokes\":" + String((unsigned)spokesCount()) +
+             ",\"pixelsPerArm\":" + String((unsigned)armPixelCount()) +
+             ",\"arms\":" + String((unsigned)activeArmCount()) +
+             ",\"spokeUs\":" + String((unsigned long)g_sched.spokeUs()) +
+             ",\"missed\":" + String((unsigned long)g_benchMissed) +
+             ",\"skipped\":" + String((unsigned long)(g_sched.skipped() - g_benchSkipBase)) +
+             ",\"spokeLatencyUs\":" + histJson(g_benchSpokeUs) +
+             ",\"paintUs\":" + histJson(g_benchPaintUs) +
+             ",\"frameLoadUs\":" + histJson(g_benchLoadUs) + "}";
+  server.send(200, "application/json", j);
+}
+
 static void handleDiagMap() {
   if (!g_frameValid || !g_frameBuf) { server.send(409,"application/json","{\"error\":\"no frame\"}"); return; }
+  if (g_nativeSeq) { server.send(409,"application/json","{\"error\":\"native sequence has no channel map\"}"); return; }
   uint8_t arm = server.hasArg("arm") ? (uint8_t)constrain(server.arg("arm").toInt()-1,0,(int)activeArmCount()-1) : 0;
 long _pixReq   = server.hasArg("pix")   ? server.arg("pix").toInt()   : 0L;
 long _spokeReq = server.hasArg("spoke") ? server.arg("spoke").toInt() : (long)currentSpokeIndex();
@@ -1606,21 +3361,11 @@ uint16_t pix   = (uint16_t)std::max<long>(0L, _pixReq);
 uint16_t spoke = (uint16_t)std::max<long>(0L, _spokeReq);
 
 
-  const uint8_t arms = activeArmCount();
-  const uint16_t pixelCount = armPixelCount();
   const uint16_t spokes = spokesCount();
-  const uint32_t expectedPerSpoke = (uint32_t)arms * (uint32_t)pixelCount * 3u;
-  const bool perSpokeFrame = (g_fh.channelCount == expectedPerSpoke);
+  bool perSpokeFrame; uint32_t chPerSpoke;
+  spokeFrameLayout(g_fh.channelCount, perSpokeFrame, chPerSpoke);
 
-  uint32_t chPerSpoke = expectedPerSpoke;
-  if (!perSpokeFrame && spokes>0 && (g_fh.channelCount % spokes)==0) chPerSpoke = g_fh.channelCount / spokes;
-
-  uint32_t base = 0;
-  if (g_usePerArmStart) base = (g_startChArm[arm] ? g_startChArm[arm]-1 : 0);
-  else {
-    const uint32_t armBlockStride = (uint32_t)pixelCount*3u;
-    base = (g_startChArm1 ? g_startChArm1-1 : 0) + (uint32_t)arm*armBlockStride;
-  }
+  uint32_t base = armBaseChannel(arm);
   if (!perSpokeFrame) base += ((uint32_t)(spoke % (spokes?spokes:1))) * chPerSpoke;
 
   uint32_t ofs = (uint32_t)pix*3u;
@@ -1638,13 +3383,14 @@ uint16_t spoke = (uint16_t)std::max<long>(0L, _spokeReq);
      + ",\"chPerSpoke\":" + String(chPerSpoke)
      + ",\"absR\":" + String(absR)
      + ",\"idxR\":" + String((long)idxR)
+     + ",\"xlate\":\"" + sparseModeName(g_sparseMode) + "\""
      + ",\"rgb\":[" + String(R) + "," + String(G) + "," + String(B) + "]"
      + "}";
   server.send(200,"application/json",j);
 }
 
 static void handleFseqRanges() {
-  String s = "{\"sparse\":" + String((int)g_fh.sparseCnt) + ",\"ranges\":[";
+  String s = "{\"sparse\":" + String((int)g_fh.sparseCnt) + ",\"xlate\":\"" + sparseModeName(g_sparseMode) + "\",\"ranges\":[";
   for (uint8_t i=0;i<g_fh.sparseCnt && i<24;i++) {
     if (i) s += ",";
     s += "{\"i\":" + String(i)
@@ -1658,6 +3404,7 @@ static void handleFseqRanges() {
 
 /* -------------------- SD Recovery Ladder -------------------- */
 static bool recoverSd(const char* reason) {
+  ++g_sdStats.recoveries;
   Serial.printf("[SD] Recover: %s  streak=%d  freq=%lu kHz  CD=%d  width=%u\n",
       reason, g_sdFailStreak, (unsigned long)g_sdFreqKHz,
       (int)digitalRead(PIN_SD_CD), (unsigned)g_sdBusWidth);
@@ -1715,6 +3462,18 @@ static bool recoverSd(const char* reason) {
 
 
 /* -------------------- Strobe & per-arm phase handlers -------------------- */
+static void handleGamma() {
+  if (!server.hasArg("value")) { server.send(400, "application/json", "{\"error\":\"missing value\"}"); return; }
+  float g = server.arg("value").toFloat();
+  if (g < 1.0f) g = 1.0f;
+  if (g > 3.0f) g = 3.0f;
+  g_gammaX10 = (uint8_t)lroundf(g * 10.0f);
+  prefs.putUChar("gamma", g_gammaX10);
+  __atomic_add_fetch(&g_encGen, 1, __ATOMIC_RELEASE);
+  renderPost(RCMD_BRIGHTNESS);
+  server.send(200, "application/json", String("{\"gamma\":") + String(g_gammaX10 / 10.0f, 1) + "}");
+}
+
 static void handleStrobe() {
   bool haveEnable = server.hasArg("enable");
   bool haveDeg    = server.hasArg("deg");
@@ -1788,8 +3547,9 @@ static void setOutputMode(uint8_t mode) {
   g_outputMode = mode;
   prefs.putUChar("outmode", g_outputMode);
   persistSettingsToSd();
-  if (g_outputMode == OUT_PARALLEL) configureParallelPins();
-  blackoutAll();
+  renderPost(RCMD_REBUILD);    // outputs are rebuilt for the new mode on the render core
+  renderSync();
+  if (g_fseq) publishPixelLut();   // arm reversal changed with the routes
 }
 static void handleOutMode() {
   if (!server.hasArg("mode")) { server.send(400,"application/json","{\"error\":\"missing mode\"}"); return; }
@@ -1835,12 +3595,17 @@ static void startWifiAP(){
   // Playback & settings
   server.on("/play",    HTTP_GET,  handlePlayLink);
   server.on("/b",       HTTP_POST, handleB);
+  server.on("/gamma",   HTTP_POST, handleGamma);
   server.on("/start",   HTTP_GET,  handleStart);
   server.on("/stop",    HTTP_POST, handleStop);
   server.on("/pause",   HTTP_POST, handlePause);
   server.on("/halldiag", HTTP_POST, handleHallDiag);
   server.on("/armtest", HTTP_POST, handleArmTest);
   server.on("/speed",   HTTP_POST, handleSpeed);
+  server.on("/frameswap", HTTP_POST, handleFrameSwap);
+  server.on("/seqcache",  HTTP_POST, handleSeqCache);
+  server.on("/transcode", HTTP_GET,  handleTranscode);
+  server.on("/transcode", HTTP_POST, handleTranscode);
   server.on("/mapcfg",  HTTP_POST, handleMapCfg);
   server.on("/wifi",    HTTP_POST, handleWifiCfg);
   server.on("/autoplay",HTTP_POST, handleAutoplay);
@@ -1862,11 +3627,19 @@ static void startWifiAP(){
 
   // Diagnostics
   server.on("/diag/map",    HTTP_GET,  handleDiagMap);
+  server.on("/bench/kernels", HTTP_GET, handleBenchKernels);
+  server.on("/hall/trace",  HTTP_POST, handleHallTrace);
+  server.on("/hall/replay", HTTP_GET,  handleHallReplay);
+  server.on("/bench",       HTTP_GET,  handleBench);
+  server.on("/metrics",     HTTP_GET,  handleMetrics);
+  server.on("/bench",       HTTP_POST, handleBench);
   server.on("/fseq/ranges", HTTP_GET,  handleFseqRanges);
   server.on("/fseq/header", HTTP_GET,  handleFseqHeader);
   server.on("/fseq/cblocks",HTTP_GET,  handleCBlocks);
+  server.on("/seek",        HTTP_POST, handleSeek);
   server.on("/sd/reinit",   HTTP_POST, handleSdReinit);
   server.on("/sd/config",   HTTP_POST, handleSdConfig);
+  server.on("/sd/calibrate", HTTP_POST, handleSdCalibrate);
 
   // Files
   server.on("/files",   HTTP_GET,  handleFiles);
@@ -1877,6 +3650,7 @@ static void startWifiAP(){
 
   // Upload FSEQ
   server.on("/upload",  HTTP_POST, handleUploadDone, handleUploadData);
+  server.on("/upload",  HTTP_PUT,  handleRawUploadDone, handleRawUploadData);
 
   // Updates hub / OTA / FW to SD
   server.on("/updates",    HTTP_GET,  handleUpdatesPage);
@@ -1918,7 +3692,7 @@ void setup(){
   present.sdMode = prefs.isKey("sdmode");
   g_sdPreferredBusWidth = sanitizeSdMode(prefs.getUChar("sdmode", (uint8_t)SD_BUS_AUTO));
   present.sdFreq = prefs.isKey("sdfreq");
-  g_sdBaseFreqKHz = sanitizeSdFreq(prefs.getUInt("sdfreq", 8000));
+  g_sdBaseFreqKHz = sanitizeSdFreq(prefs.getUInt("sdfreq", SD_FREQ_AUTO_KHZ));
   g_sdFreqKHz = g_sdBaseFreqKHz;
   present.brightness = prefs.isKey("brightness");
   g_brightnessPercent = prefs.getUChar("brightness", 25);
@@ -1964,16 +3738,18 @@ void setup(){
     }
   }
 
-  // RPM prefs & ISR
+  // RPM prefs & Hall capture
   g_pulsesPerRev = prefs.getUChar("ppr", PULSES_PER_REV);
   if (g_pulsesPerRev < 1) g_pulsesPerRev = 1;
   g_hallEdgeMode = prefs.getUChar("hedge", 0);
   attachHallInterrupt();
 
+  g_gammaX10 = prefs.getUChar("gamma", 10);
+  if (g_gammaX10 < 10 || g_gammaX10 > 30) g_gammaX10 = 10;
+
   // Output mode pref (default SPI)
   g_outputMode = prefs.getUChar("outmode", (uint8_t)OUT_SPI);
   if (g_outputMode != OUT_SPI && g_outputMode != OUT_PARALLEL) g_outputMode = OUT_SPI;
-  if (g_outputMode == OUT_PARALLEL) configureParallelPins();
 
   // Strobe prefs (NEW): defaults to disabled
   g_strobeEnable   = prefs.getBool("strb_e", false);
@@ -1996,12 +3772,15 @@ void setup(){
     if (g_sdMutex && SD_LOCK(pdMS_TO_TICKS(2000))) { ensureBgEffectsDirLocked(); SD_UNLOCK(); }
   }
 
-  applyWatchdogSetting();
-
   if (g_brightnessPercent > 100) g_brightnessPercent = 100;
   g_brightness = (uint8_t)((255 * g_brightnessPercent) / 100);
   if (!g_fps) g_fps = 40;
-  g_framePeriodMs = 1000UL / g_fps;
+  g_fpsFromFile = prefs.getBool("fpsfile", true);
+  g_swapAlign     = prefs.getBool("swalign", true);
+  g_swapStep      = prefs.getUShort("swspoke", 0);
+  g_swapTimeoutMs = prefs.getUShort("swto", 250);
+  g_seqBudgetKB   = prefs.getUShort("sqbudget", 2048);
+  g_povAuto       = prefs.getBool("povauto", true);
   if (!g_startChArm1) g_startChArm1 = 1;
   if (!g_spokesTotal) g_spokesTotal = 1;
   g_armCount = clampArmCount(g_armCount);
@@ -2014,7 +3793,7 @@ void setup(){
     Serial.printf("Arm %d → spoke %d\n", k+1, s0 + 1);
   }
   Serial.printf("[BRIGHTNESS] %u%% (%u)\n", g_brightnessPercent, g_brightness);
-  Serial.printf("[PLAY] FPS=%u  period=%lums\n", g_fps, (unsigned long)g_framePeriodMs);
+  Serial.printf("[PLAY] rate: %s (override fps=%u)\n", g_fpsFromFile ? "file step time" : "override", g_fps);
   Serial.printf("[MAP] startCh(Arm1)=%lu spokes=%u arms=%u pixels/arm=%u\n",
                 (unsigned long)g_startChArm1, g_spokesTotal, (unsigned)activeArmCount(),
                 (unsigned)g_pixelsPerArm);
@@ -2046,45 +3825,129 @@ void setup(){
   g_rpmLastCount = g_pulseCount;
   g_rpmAccumulatedUs = 0;
   g_rpmAccumulatedPulses = 0;
+
+  startRenderAndIoTasks();
+  applyWatchdogSetting(); // subscribes the render + I/O tasks
   Serial.println("[STATE] Waiting for selection via web UI (5-min timeout to /test2.fseq)");
 }
 
-void loop(){
-  pollWifiStation();
-  server.handleClient();
-  updateHallSensor();
-  updateArmTest();
+/* -------------------- Render core (spokes + lanes only) -------------------- */
+static void applyLaneBrightness(){
+  refreshLaneLevels();
+  lanesShowAll();
+}
 
-  static uint32_t lastRpmPoll = 0;
-  uint32_t nowMs = millis();
-  if (nowMs - lastRpmPoll >= 250) { (void)computeRpmSnapshot(); lastRpmPoll = nowMs; }
+static void drainRenderQueue(){
+  RenderCmd cmd;
+  while (xQueueReceive(g_renderQueue, &cmd, 0) == pdTRUE) {
+    switch (cmd.type) {
+      case RCMD_BLACKOUT:   blackoutAll(); break;
+      case RCMD_REBUILD:    rebuildStrips(); break;
+      case RCMD_BRIGHTNESS: applyLaneBrightness(); break;
+      case RCMD_LANEDIAG:   showLaneDiag(); break;
+      case RCMD_SYNC:       xSemaphoreGive(g_renderAck); break;
+      case RCMD_PIXLUT:     installPixelLut((PixelLut*)cmd.ptr); break;
+      case RCMD_RING_FLUSH: flushFrameRing(); break;
+      case RCMD_BENCH:      benchStart((BenchRequest*)cmd.ptr); break;
+      case RCMD_BENCH_STOP: benchStop(); break;
+    }
+  }
+}
 
-  feedWatchdog();
+/* -------------------- Spoke timer (gptimer) -------------------- */
+// A 1 MHz gptimer wakes the render task at the exact spoke start / blank time
+// instead of the loop polling micros().  The SPI and LCD drivers cannot queue
+// a transfer from an ISR, so the alarm notifies the render task (highest
+// priority on its core), which parked with the spoke already drawn and only
+// has to start the transfers.
+static const int32_t    SPOKE_TIMER_MIN_US = 15;   // closer than this: spin instead of sleeping
 
-  if (g_bgEffectEnabled && g_bgEffectPath.length() && !g_hallDiagEnabled && !g_armTestEnabled && !g_playing) {
-    uint32_t now = millis();
-    if (now >= g_bgEffectNextAttemptMs) {
-      String why;
-      g_paused = false;
-      if (openFseq(g_bgEffectPath, why)) { Serial.printf("[BGE] Auto-start %s\n", g_bgEffectPath.c_str()); g_bgEffectNextAttemptMs = now; }
-      else { Serial.printf("[BGE] open fail: %s\n", why.c_str()); g_bgEffectNextAttemptMs = now + 5000; }
-    }
+static bool IRAM_ATTR spokeTimerIsr(gptimer_handle_t, const gptimer_alarm_event_data_t*, void*) {
+  BaseType_t woken = pdFALSE;
+  if (g_renderTask) vTaskNotifyGiveFromISR(g_renderTask, &woken);
+  return woken == pdTRUE;
+}
+
+// Called on the render core so the alarm interrupt lands there too
+static void beginSpokeTimer(){
+  gptimer_config_t cfg = {};
+  cfg.clk_src       = GPTIMER_CLK_SRC_DEFAULT;
+  cfg.direction     = GPTIMER_COUNT_UP;
+  cfg.resolution_hz = 1000000;
+  if (gptimer_new_timer(&cfg, &g_spokeTimer) != ESP_OK) {
+    Serial.println("[SCHED] no gptimer free, polling spokes");
+    g_spokeTimer = nullptr;
+    return;
   }
+  gptimer_event_callbacks_t cbs = {};
+  cbs.on_alarm = spokeTimerIsr;
+  gptimer_register_event_callbacks(g_spokeTimer, &cbs, nullptr);
+  gptimer_enable(g_spokeTimer);
+  gptimer_start(g_spokeTimer);
+}
+
+// Park until atUs on the micros() timeline.  false if a Hall edge cut it short.
+static bool waitUntilUs(uint32_t atUs){
+  for (;;) {
+    if (hallPending()) return false;
+    const int32_t d = (int32_t)(atUs - micros());
+    if (d <= 0) return true;
+    if (!g_spokeTimer || d <= SPOKE_TIMER_MIN_US) break;
+    uint64_t count = 0;
+    gptimer_get_raw_count(g_spokeTimer, &count);
+    gptimer_alarm_config_t alarm = {};
+    alarm.alarm_count = count + (uint64_t)d;
+    ulTaskNotifyTake(pdTRUE, 0);                 // drop a stale wake-up
+    gptimer_set_alarm_action(g_spokeTimer, &alarm);
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(2) + 1);
+    ++g_schedWakeups;
+  }
+  while ((int32_t)(atUs - micros()) > 0) { }
+  return true;
+}
 
-  if (g_autoplayEnabled && (!g_playing || g_bgEffectActive) && !g_hallDiagEnabled && !g_armTestEnabled && (millis() - g_bootMs > SELECT_TIMEOUT_MS)) {
-    String why;
-    g_paused = false;
-    if (openFseq("/test2.fseq", why)) { Serial.println("[TIMEOUT] Auto-start /test2.fseq"); }
-    else { Serial.printf("[TIMEOUT] open fail: %s\n", why.c_str()); g_bootMs = millis(); }
+// Sleep until the next spoke start or blank.  An upcoming spoke is drawn into
+// the back buffers first, so at the deadline only the commit is left.
+static void waitForNextRenderEvent(){
+  uint32_t atUs; bool spoke;
+  const uint32_t nowUs = micros();
+  if (hallPending()) return;
+  if (!g_sched.nextEvent(nowUs, atUs, spoke) || (int32_t)(atUs - nowUs) > (int32_t)RENDER_IDLE_SLACK_US) {
+    vTaskDelay(1);   // rotor stopped or slow: give the tick back
+    return;
   }
+  if ((int32_t)(atUs - nowUs) <= 0) return;
+  if (spoke && !g_sched.isPrepared(g_sched.upcomingStep())) {
+    paintSpokeStep(g_sched.upcomingStep(), atUs);
+    g_sched.markPrepared(g_sched.upcomingStep());
+  }
+  if (!waitUntilUs(atUs)) return;
+
+  const uint32_t t = micros();
+  advancePredictedSpokes(t);
+  processArmBlanking(t);
+  commitOutputs();
+  benchSpokeCommitted();
+  g_schedLateUsLast = (uint32_t)((int32_t)(t - atUs) > 0 ? t - atUs : 0);
+  if (g_schedLateUsLast > g_schedLateUsMax) g_schedLateUsMax = g_schedLateUsLast;
+}
+
+static void renderStep(){
+  drainRenderQueue();
+  if (g_benchOn && g_benchUntilMs && (int32_t)(millis() - g_benchUntilMs) >= 0) benchStop();
+  drainHallEdges(micros(), g_playing && !g_paused);
+  updateHallSensor();
+  updateArmTest();
 
   if (!g_playing || g_paused) {
+    commitOutputs();
     if (PIN_STROBE_GATE >= 0) digitalWrite(PIN_STROBE_GATE, LOW);
-    delay(1);
-    feedWatchdog();
+    vTaskDelay(1);
     return;
   }
 
+  tickFrameClock();
+
   const uint16_t spokeNow = currentSpokeIndex();
 
   if (PIN_STROBE_GATE >= 0) {
@@ -2092,35 +3955,8 @@ void loop(){
     digitalWrite(PIN_STROBE_GATE, on ? HIGH : LOW);
   }
 
-  const uint32_t now = millis();
-  if (now - g_lastTickMs >= g_framePeriodMs) {
-    g_lastTickMs = now;
-
-    if (!loadNextFrame()) {
-      ++g_sdFailStreak;
-      Serial.printf("[PLAY] frame read failed — streak=%d\n", g_sdFailStreak);
-      if (!recoverSd("frame read failed")) {
-        if (g_sdFailStreak >= 6) {
-          Serial.println("[SD] Unrecoverable — pausing playback.");
-          g_playing = false;
-          g_bgEffectActive = false;
-          g_bgEffectNextAttemptMs = millis();
-          g_sdFailStreak = 0;
-          g_frameValid = false;
-          blackoutAll();
-        }
-      }
-      feedWatchdog();
-      return;
-    }
-
-    g_sdFailStreak = 0;
-  }
-
   uint32_t nowUs = micros();
   if (g_strobeEnable) {
-    processHallSyncEvent(nowUs);
-
     const uint16_t spokeNow2 = currentSpokeIndex();
     const uint8_t arms = activeArmCount();
 
@@ -2130,41 +3966,123 @@ void loop(){
       if (in && g_lastPulseSpoke[a] != spokeNow2) {
         paintArmAt(a, spokeNow2, nowUs);
         g_lastPulseSpoke[a] = spokeNow2;
-        g_armState[a].lit = true;
       }
 
-      if (!in && g_armState[a].lit) blankArm(a);
+      if (!in && g_sched.isLit(a)) blankArm(a);
     }
+    commitOutputs();
   } else {
-    processHallSyncEvent(nowUs);
     advancePredictedSpokes(nowUs);
     processArmBlanking(nowUs);
+    commitOutputs();
+    benchSpokeCommitted();
+    waitForNextRenderEvent();
   }
+}
+
+static void renderTask(void*){
+  beginSpokeTimer();
+  for (;;) {
+    renderStep();
+    feedWatchdog();
+  }
+}
+
+/* -------------------- I/O core (web, Wi-Fi, SD, frame loading) -------------------- */
+static void ioStep(){
+  pollWifiStation();
+  server.handleClient();
+
+  static uint32_t lastRpmPoll = 0;
+  uint32_t nowMs = millis();
+  if (nowMs - lastRpmPoll >= 250) { (void)computeRpmSnapshot(); lastRpmPoll = nowMs; }
 
   feedWatchdog();
+
+  if (g_bgEffectEnabled && g_bgEffectPath.length() && !g_hallDiagEnabled && !g_armTestEnabled && !g_playing) {
+    uint32_t now = millis();
+    if (now >= g_bgEffectNextAttemptMs) {
+      String why;
+      g_paused = false;
+      if (openFseq(g_bgEffectPath, why)) { Serial.printf("[BGE] Auto-start %s\n", g_bgEffectPath.c_str()); g_bgEffectNextAttemptMs = now; }
+      else { Serial.printf("[BGE] open fail: %s\n", why.c_str()); g_bgEffectNextAttemptMs = now + 5000; }
+    }
+  }
+
+  if (g_autoplayEnabled && (!g_playing || g_bgEffectActive) && !g_hallDiagEnabled && !g_armTestEnabled && (millis() - g_bootMs > SELECT_TIMEOUT_MS)) {
+    String why;
+    g_paused = false;
+    if (openFseq("/test2.fseq", why)) { Serial.println("[TIMEOUT] Auto-start /test2.fseq"); }
+    else { Serial.printf("[TIMEOUT] open fail: %s\n", why.c_str()); g_bootMs = millis(); }
+  }
+
+  // Native twin finished or went stale: reopen in place (picks the twin up or drops it)
+  if (g_povReopen && !(g_playing && g_paused)) {
+    g_povReopen = false;
+    if (g_playing && g_currentPath.length()) {
+      const String path = g_currentPath;
+      String why;
+      if (!openFseqAt(path, why, g_frameIndex)) Serial.printf("[POV] reopen %s failed: %s\n", path.c_str(), why.c_str());
+    }
+  }
+
+  if (!g_playing || g_paused) return;
+
+  // Frame loading lives in the prefetch task; only its failures are handled here
+  if (g_prefetchFailed) {
+    ++g_sdFailStreak;
+    Serial.printf("[PLAY] frame read failed — streak=%d\n", g_sdFailStreak);
+    if (recoverSd("frame read failed")) return;   // reopen restarted the pipeline
+    if (g_sdFailStreak >= 6) {
+      Serial.println("[SD] Unrecoverable — pausing playback.");
+      g_playing = false;
+      g_bgEffectActive = false;
+      g_bgEffectNextAttemptMs = millis();
+      g_sdFailStreak = 0;
+      g_frameValid = false;
+      renderPost(RCMD_BLACKOUT);
+    } else {
+      g_prefetchFailed = false;   // let the producer retry
+      if (g_prefetchTask) xTaskNotifyGive(g_prefetchTask);
+    }
+  }
+}
+
+static void ioTask(void*){
+  for (;;) {
+    ioStep();
+    feedWatchdog();
+    vTaskDelay(1);
+  }
+}
+
+static void startRenderAndIoTasks(){
+  g_renderQueue = xQueueCreate(RENDER_QUEUE_LEN, sizeof(RenderCmd));
+  g_renderAck   = xSemaphoreCreateBinary();
+  g_pipeMutex   = xSemaphoreCreateMutex();
+  xTaskCreatePinnedToCore(renderTask, "render", RENDER_STACK, nullptr, RENDER_TASK_PRIO, &g_renderTask, RENDER_CORE);
+  xTaskCreatePinnedToCore(ioTask,     "io",     IO_STACK,     nullptr, IO_TASK_PRIO,     &g_ioTask,     IO_CORE);
+  xTaskCreatePinnedToCore(prefetchTask, "prefetch", PREFETCH_STACK, nullptr, PREFETCH_TASK_PRIO, &g_prefetchTask, IO_CORE);
+  Serial.printf("[TASK] render on core %d, I/O on core %d\n", (int)RENDER_CORE, (int)IO_CORE);
+}
+
+// All work lives in the pinned render / I/O tasks
+void loop(){
+  vTaskDelete(nullptr);
 }
 
 // ====== SPI/Parallel-aware blanker ======
 static void blankArm(uint8_t arm){
+  StageTimer st(MS_BLANK);
   if (arm >= MAX_ARMS) return;
 
-  if (g_outputMode == OUT_PARALLEL) {
-    if (g_strobeEnable && PIN_STROBE_GATE >= 0) {
-      g_armState[arm].lit = false;
-      g_armState[arm].blankDeadlineUs = 0;
-      return;
-    }
-    if (arm == 0) {
-      configureParallelPins();
-      sk9822_tx_parallel_black();
-      const uint8_t arms = activeArmCount();
-      for (uint8_t a=0; a<arms; ++a) { g_armState[a].lit = false; g_armState[a].blankDeadlineUs = 0; }
-    }
+  // Parallel + strobe gate: the gate already darkens the arms
+  if (g_par && g_strobeEnable && PIN_STROBE_GATE >= 0) {
+    g_sched.dark(arm);
     return;
   }
 
-  // SPI: clear that arm's segment only
+  // Clear that arm's segment only; it goes out with the tick's commit
   armClear(arm);
-  g_armState[arm].lit = false;
-  g_armState[arm].blankDeadlineUs = 0;
+  g_sched.dark(arm);
 }
@@ -0,0 +1,168 @@
+#include "LaneOutput.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#endif
+
+/* -------------------- LaneSink defaults -------------------- */
+uint8_t* LaneSink::allocBuffer(size_t bytes) { return (uint8_t*)malloc(bytes); }
+void     LaneSink::freeBuffer(uint8_t* p)    { free(p); }
+
+/* -------------------- LaneOutput -------------------- */
+void LaneOutput::initWire(uint8_t* buf, uint16_t leds) {
+  memset(buf, 0x00, START_BYTES);
+  uint8_t* p = buf + START_BYTES;
+  for (uint16_t i = 0; i < leds; ++i, p += 4) { p[0] = 0xFF; p[1] = p[2] = p[3] = 0; }
+  memset(p, 0xFF, ((size_t)leds + 15) / 16);
+}
+
+LaneOutput::~LaneOutput() {
+  flush();
+  if (_sink) {
+    if (_back)  _sink->freeBuffer(_back);
+    if (_front) _sink->freeBuffer(_front);
+    delete _sink;
+  }
+}
+
+bool LaneOutput::begin(LaneSink* sink, uint16_t leds) {
+  _sink  = sink;
+  _leds  = leds;
+  _bytes = wireBytesFor(leds);
+  if (!_sink) return false;
+  _back  = _sink->allocBuffer(_bytes);
+  _front = _sink->allocBuffer(_bytes);
+  if (!_back || !_front || !_sink->begin(_bytes)) return false;
+  initWire(_back, leds);
+  initWire(_front, leds);
+  return true;
+}
+
+void LaneOutput::clear() {
+  if (!_back) return;
+  uint8_t* p = _back + START_BYTES;
+  for (uint16_t i = 0; i < _leds; ++i, p += 4) { p[1] = p[2] = p[3] = 0; }
+}
+
+void LaneOutput::show() {
+  if (!_sink || !_back) return;
+  _sink->waitDone();                 // previous transfer still reads _front
+  uint8_t* t = _front; _front = _back; _back = t;
+  _sink->transmit(_front, _bytes);
+  // The other arm on this lane is not repainted every show, so the next back
+  // buffer starts as a copy of what is on the wire (DMA only reads _front).
+  memcpy(_back, _front, _bytes);
+  ++_shows;
+}
+
+size_t LaneOutput::show(uint16_t leds) {
+  if (leds >= _leds) { show(); return _bytes; }
+  if (!_sink || !_back || !leds) return 0;
+  _sink->waitDone();
+  uint8_t* t = _front; _front = _back; _back = t;
+  // Copy first: the tail below overwrites LEDs that were not sent, and the
+  // back buffer must keep them for the next full show.
+  memcpy(_back, _front, _bytes);
+  const size_t head = START_BYTES + (size_t)leds * 4;
+  const size_t tail = partialTailBytes(leds);
+  memset(_front + head, 0x00, tail);
+  _sink->transmit(_front, head + tail);
+  ++_shows;
+  return head + tail;
+}
+
+void LaneOutput::flush() {
+  if (_sink) _sink->waitDone();
+}
+
+/* -------------------- FileSink -------------------- */
+bool FileSink::begin(size_t) {
+  if (!_f) _f = fopen(_path, "wb");
+  return _f != nullptr;
+}
+
+bool FileSink::transmit(const uint8_t* buf, size_t len) {
+  if (!_f) return false;
+  const uint8_t hdr[4] = { (uint8_t)len, (uint8_t)(len >> 8), (uint8_t)(len >> 16), (uint8_t)(len >> 24) };
+  return fwrite(hdr, 1, 4, _f) == 4 && fwrite(buf, 1, len, _f) == len;
+}
+
+#if defined(ESP_PLATFORM)
+/* -------------------- SpiDmaSink -------------------- */
+SpiDmaSink::~SpiDmaSink() {
+  waitDone();
+  if (_dev) spi_bus_remove_device(_dev);
+  if (_busInit) spi_bus_free(_host);
+}
+
+bool SpiDmaSink::begin(size_t maxBytes) {
+  spi_bus_config_t bus = {};
+  bus.mosi_io_num     = _data;
+  bus.sclk_io_num     = _clk;
+  bus.miso_io_num     = -1;
+  bus.quadwp_io_num   = -1;
+  bus.quadhd_io_num   = -1;
+  bus.max_transfer_sz = (int)maxBytes;
+  if (spi_bus_initialize(_host, &bus, SPI_DMA_CH_AUTO) != ESP_OK) {
+    Serial.printf("[LANE] SPI%d bus init failed\n", (int)_host + 1);
+    return false;
+  }
+  _busInit = true;
+
+  spi_device_interface_config_t dev = {};
+  dev.clock_speed_hz = _hz;
+  dev.mode           = 0;
+  dev.spics_io_num   = -1;
+  dev.queue_size     = 1;
+  if (spi_bus_add_device(_host, &dev, &_dev) != ESP_OK) {
+    Serial.printf("[LANE] SPI%d add device failed\n", (int)_host + 1);
+    return false;
+  }
+  return true;
+}
+
+bool SpiDmaSink::transmit(const uint8_t* buf, size_t len) {
+  if (!_dev) return false;
+  memset(&_trans, 0, sizeof(_trans));
+  _trans.length    = len * 8;
+  _trans.tx_buffer = buf;
+  _inFlight = (spi_device_queue_trans(_dev, &_trans, portMAX_DELAY) == ESP_OK);
+  return _inFlight;
+}
+
+void SpiDmaSink::waitDone() {
+  if (!_inFlight) return;
+  spi_transaction_t* done = nullptr;
+  spi_device_get_trans_result(_dev, &done, portMAX_DELAY);
+  _inFlight = false;
+}
+
+uint8_t* SpiDmaSink::allocBuffer(size_t bytes) {
+  return (uint8_t*)heap_caps_malloc(bytes, MALLOC_CAP_DMA | MALLOC_CAP_8BIT);
+}
+
+void SpiDmaSink::freeBuffer(uint8_t* p) { heap_caps_free(p); }
+
+/* -------------------- GpioSink -------------------- */
+bool GpioSink::begin(size_t) {
+  pinMode(_data, OUTPUT);
+  pinMode(_clk, OUTPUT);
+  digitalWrite(_clk, LOW);
+  return true;
+}
+
+bool GpioSink::transmit(const uint8_t* buf, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    for (uint8_t bit = 0x80; bit; bit >>= 1) {
+      digitalWrite(_data, (buf[i] & bit) ? HIGH : LOW);
+      digitalWrite(_clk, HIGH);
+      digitalWrite(_clk, LOW);
+    }
+  }
+  return true;
+}
+#endif
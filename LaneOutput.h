@@ -0,0 +1,152 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// SK9822 / APA102 lane output.
+//
+// A LaneOutput owns the wire buffer for one lane (two chained arms) in the
+// exact byte layout the LEDs clock in:
+//   4 x 0x00 start frame | per LED: 0xE0|global, B, G, R | (n+15)/16 x 0xFF end frame
+// (the framing Adafruit_DotStar sends for DOTSTAR_BGR).  show() hands
+// the finished buffer to a LaneSink.  The buffer is double-buffered, so the
+// CPU can fill the next spoke while the DMA engine sends the current one.
+//
+// Sinks:
+//   SpiDmaSink - ESP32-S3 SPI2/SPI3 master with DMA (device)
+//   GpioSink   - bit-banged clock/data, fallback if the SPI host is taken (device)
+//   FileSink   - appends every frame to a stdio file (device VFS path or a
+//                Linux host build, to verify the byte stream offline)
+//
+// This header and FileSink build without Arduino so LaneOutput.cpp can be
+// compiled on a host with ESP_PLATFORM undefined.
+
+class LaneSink {
+public:
+  virtual ~LaneSink() {}
+  // Prepare for transfers of up to maxBytes
+  virtual bool begin(size_t maxBytes) = 0;
+  // Start sending buf[0..len).  buf must stay untouched until waitDone() returns.
+  virtual bool transmit(const uint8_t* buf, size_t len) = 0;
+  // Block until the last transmit() has left the wire
+  virtual void waitDone() {}
+  virtual const char* name() const = 0;
+  // Buffers handed to transmit() must come from here (DMA-capable on device)
+  virtual uint8_t* allocBuffer(size_t bytes);
+  virtual void     freeBuffer(uint8_t* p);
+};
+
+class LaneOutput {
+public:
+  LaneOutput() { for (int v = 0; v < 256; ++v) _lvl[v] = (uint8_t)v; }
+  ~LaneOutput();
+
+  // Takes ownership of sink.  false if the sink or buffers cannot be set up.
+  bool begin(LaneSink* sink, uint16_t leds);
+
+  // Output stage for setPixelColor(): per-channel level table (brightness +
+  // gamma) and the LED header byte (0xE0 | 5-bit global current).  Copied.
+  void setLevels(const uint8_t* lvl, uint8_t hdr) { memcpy(_lvl, lvl, sizeof(_lvl)); _hdr = hdr; }
+  void setPixelColor(uint16_t i, uint8_t r, uint8_t g, uint8_t b) {
+    if (i >= _leds) return;
+    uint8_t* p = _back + START_BYTES + (size_t)i * 4;
+    p[0] = _hdr;
+    p[1] = _lvl[b];
+    p[2] = _lvl[g];
+    p[3] = _lvl[r];
+  }
+  // Copy count ready-made LED words (hdr,B,G,R each) to LEDs first..first+count-1
+  void setSegment(uint16_t first, const uint8_t* words, uint16_t count) {
+    if (first >= _leds) return;
+    if (count > _leds - first) count = _leds - first;
+    memcpy(_back + START_BYTES + (size_t)first * 4, words, (size_t)count * 4);
+  }
+  // Back-buffer words for LEDs first..first+count-1, for writers that build
+  // hdr,B,G,R in place; nullptr if the run does not fit the lane
+  uint8_t* wordsAt(uint16_t first, uint16_t count) {
+    if (!_back || (uint32_t)first + count > _leds) return nullptr;
+    return _back + START_BYTES + (size_t)first * 4;
+  }
+  void clear();
+  // Send the back buffer; returns once the transfer is queued
+  void show();
+  // Send only LEDs 0..leds-1 (partial shift): the LEDs past them keep what
+  // they latched last time.  Returns the bytes queued; leds >= numPixels()
+  // is a full show().
+  size_t show(uint16_t leds);
+  // Wait for the in-flight transfer (before the sink or buffers go away)
+  void flush();
+
+  uint16_t    numPixels() const { return _leds; }
+  size_t      wireBytes() const { return _bytes; }
+  const char* sinkName()  const { return _sink ? _sink->name() : "none"; }
+  uint32_t    shows()     const { return _shows; }
+
+  static const size_t START_BYTES = 4;
+  static size_t wireBytesFor(uint16_t leds) { return START_BYTES + (size_t)leds * 4 + ((size_t)leds + 15) / 16; }
+  // Tail after a partial run of leds: zeros, which the next LED reads as a
+  // start frame (a 0xFF end frame would latch there as a white pixel).  Four
+  // bytes for the SK9822 latch plus half a clock per LED to flush the chain.
+  static size_t partialTailBytes(uint16_t leds) { return 4 + ((size_t)leds + 15) / 16; }
+  // Lay out start frame, LED headers and end frame; pixels are black
+  static void initWire(uint8_t* buf, uint16_t leds);
+
+private:
+  LaneSink* _sink  = nullptr;
+  uint8_t*  _back  = nullptr;   // written by setPixelColor()
+  uint8_t*  _front = nullptr;   // owned by the sink while a transfer is in flight
+  uint16_t  _leds  = 0;
+  size_t    _bytes = 0;
+  uint8_t   _lvl[256];
+  uint8_t   _hdr   = 0xFF;
+  uint32_t  _shows = 0;
+};
+
+// Appends each transmitted frame to a file as <u32 little-endian length><bytes>
+class FileSink : public LaneSink {
+public:
+  explicit FileSink(const char* path) : _path(path) {}
+  ~FileSink() override { if (_f) fclose(_f); }
+  bool begin(size_t maxBytes) override;
+  bool transmit(const uint8_t* buf, size_t len) override;
+  const char* name() const override { return "file"; }
+private:
+  const char* _path;
+  FILE*       _f = nullptr;
+};
+
+#if defined(ESP_PLATFORM)
+#include <driver/spi_master.h>
+
+class SpiDmaSink : public LaneSink {
+public:
+  SpiDmaSink(spi_host_device_t host, int dataPin, int clkPin, int hz)
+    : _host(host), _data(dataPin), _clk(clkPin), _hz(hz) {}
+  ~SpiDmaSink() override;
+  bool begin(size_t maxBytes) override;
+  bool transmit(const uint8_t* buf, size_t len) override;
+  void waitDone() override;
+  const char* name() const override { return "spi-dma"; }
+  uint8_t* allocBuffer(size_t bytes) override;
+  void     freeBuffer(uint8_t* p) override;
+private:
+  spi_host_device_t   _host;
+  int                 _data, _clk, _hz;
+  spi_device_handle_t _dev    = nullptr;
+  bool                _busInit = false;
+  bool                _inFlight = false;
+  spi_transaction_t   _trans;
+};
+
+class GpioSink : public LaneSink {
+public:
+  GpioSink(int dataPin, int clkPin) : _data(dataPin), _clk(clkPin) {}
+  bool begin(size_t maxBytes) override;
+  bool transmit(const uint8_t* buf, size_t len) override;
+  const char* name() const override { return "gpio"; }
+private:
+  int _data, _clk;
+};
+#endif
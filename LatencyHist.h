@@ -0,0 +1,64 @@
+#pragma once
+#include <stdint.h>
+
+// Log2-bucketed latency histogram.  Bucket 0 holds 0, bucket i (>= 1) holds
+// [2^(i-1), 2^i); the last bucket takes everything above.  add() is a few
+// instructions and touches no heap, so it can sit in the render loop.  One
+// writer; readers on another core may see a sample half-counted, which is
+// fine for reporting.  Portable (no Arduino), units are the caller's.
+//
+// N buckets cover [0, 2^(N-1)): 24 for microseconds (8 s), 32 for raw CPU
+// cycles (24 buckets at 240 MHz would end at 35 ms and every slow SD or lock
+// wait would land in the catch-all bucket, so p99 would only echo max()).
+
+template <uint8_t N>
+class LatencyHistN {
+  static_assert(N >= 2 && N <= 32, "LatencyHistN: 2..32 buckets");
+public:
+  static const uint8_t BUCKETS = N;
+
+  void reset() {
+    for (uint8_t i = 0; i < BUCKETS; ++i) _b[i] = 0;
+    _n = 0; _sum = 0; _min = UINT32_MAX; _max = 0;
+  }
+
+  void add(uint32_t v) {
+    uint8_t i = 0;
+    if (v) { i = (uint8_t)(32 - __builtin_clz(v)); if (i >= BUCKETS) i = BUCKETS - 1; }
+    ++_b[i]; ++_n; _sum += v;
+    if (v < _min) _min = v;
+    if (v > _max) _max = v;
+  }
+
+  uint32_t count()           const { return _n; }
+  uint64_t sum()             const { return _sum; }
+  uint32_t min()             const { return _n ? _min : 0; }
+  uint32_t max()             const { return _max; }
+  uint32_t mean()            const { return _n ? (uint32_t)(_sum / _n) : 0; }
+  uint32_t bucket(uint8_t i) const { return i < BUCKETS ? _b[i] : 0; }
+
+  // Exclusive upper bound of bucket i (the last one is open-ended: UINT32_MAX)
+  static uint32_t upper(uint8_t i) { return i == 0 ? 1 : (i >= BUCKETS - 1 ? UINT32_MAX : (1u << i)); }
+
+  // Largest value of the bucket holding the p-th percentile (0..100), capped at max()
+  uint32_t percentile(uint8_t p) const {
+    if (!_n) return 0;
+    const uint64_t want = ((uint64_t)_n * p + 99) / 100;
+    uint64_t acc = 0;
+    for (uint8_t i = 0; i < BUCKETS; ++i) {
+      acc += _b[i];
+      if (acc >= want) { const uint32_t u = i ? upper(i) - 1 : 0; return u < _max ? u : _max; }
+    }
+    return _max;
+  }
+
+private:
+  uint32_t _b[BUCKETS] = { 0 };
+  uint32_t _n   = 0;
+  uint64_t _sum = 0;
+  uint32_t _min = UINT32_MAX;
+  uint32_t _max = 0;
+};
+
+typedef LatencyHistN<24> LatencyHist;   // microseconds, nanoseconds on a host
+typedef LatencyHistN<32> CycleHist;     // CPU cycle counts
@@ -0,0 +1,122 @@
+#include "ParallelOutput.h"
+
+#if defined(ESP_PLATFORM)
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <esp_idf_version.h>
+#include <esp_rom_gpio.h>
+#include <driver/gpio.h>
+#include "soc/lcd_periph.h"
+#include "BitTranspose.h"
+#include "LaneOutput.h"
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 3, 0)
+  #define PAR_I80_SIGNALS lcd_periph_i80_signals
+#else
+  #define PAR_I80_SIGNALS lcd_periph_signals
+#endif
+
+ParallelOutput::~ParallelOutput() {
+  flush();
+  if (_io)  esp_lcd_panel_io_del(_io);
+  if (_bus) esp_lcd_del_i80_bus(_bus);
+  for (uint8_t l = 0; l < MAX_LINES; ++l) if (_arm[l]) free(_arm[l]);
+  for (uint8_t i = 0; i < 2; ++i) if (_busBuf[i]) heap_caps_free(_busBuf[i]);
+  if (_done) vSemaphoreDelete(_done);
+  for (uint8_t i = 0; i < _pinCount; ++i) gpio_reset_pin((gpio_num_t)_pins[i]);
+}
+
+bool ParallelOutput::onDone(esp_lcd_panel_io_handle_t, esp_lcd_panel_io_event_data_t*, void* ctx) {
+  BaseType_t woken = pdFALSE;
+  xSemaphoreGiveFromISR(((ParallelOutput*)ctx)->_done, &woken);
+  return woken == pdTRUE;
+}
+
+bool ParallelOutput::begin(const int* dataPins, const int* clkPins, uint8_t lines, uint16_t leds, uint32_t hz) {
+  if (!bitTransposeSelfTest()) {
+    Serial.println("[Parallel self-check] transpose round-trip FAILED");
+    return false;
+  }
+  Serial.println("[Parallel self-check] transpose round-trip OK");
+
+  if (lines == 0 || lines > MAX_LINES) return false;
+  _lines    = lines;
+  _leds     = leds;
+  _armBytes = LaneOutput::wireBytesFor(leds);
+  const size_t busBytes = _armBytes * 8;
+
+  _done = xSemaphoreCreateBinary();
+  if (!_done) return false;
+  for (uint8_t l = 0; l < lines; ++l) {
+    _arm[l] = (uint8_t*)malloc(_armBytes);
+    if (!_arm[l]) return false;
+    LaneOutput::initWire(_arm[l], leds);
+  }
+  for (uint8_t i = 0; i < 2; ++i) {
+    _busBuf[i] = (uint8_t*)heap_caps_malloc(busBytes, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (!_busBuf[i]) { Serial.println("[PAR] no DMA memory"); return false; }
+  }
+
+  // The i80 bus insists on 8 data lines plus DC.  Lines we do not use are
+  // parked on our own data pins and DC on the clock pin; both get re-routed to
+  // the right signals below, so nothing extra is driven.
+  esp_lcd_i80_bus_config_t bus = {};
+  bus.dc_gpio_num = clkPins[0];
+  bus.wr_gpio_num = clkPins[0];
+  bus.clk_src     = LCD_CLK_SRC_DEFAULT;
+  for (uint8_t i = 0; i < 8; ++i) bus.data_gpio_nums[i] = dataPins[i % lines];
+  bus.bus_width          = 8;
+  bus.max_transfer_bytes = busBytes;
+  if (esp_lcd_new_i80_bus(&bus, &_bus) != ESP_OK) { Serial.println("[PAR] i80 bus init failed"); return false; }
+
+  esp_lcd_panel_io_i80_config_t io = {};
+  io.cs_gpio_num         = -1;
+  io.pclk_hz             = hz;
+  io.trans_queue_depth   = 2;
+  io.on_color_trans_done = onDone;
+  io.user_ctx            = this;
+  io.lcd_cmd_bits        = 8;
+  io.lcd_param_bits      = 8;
+  if (esp_lcd_new_panel_io_i80(_bus, &io, &_io) != ESP_OK) { Serial.println("[PAR] i80 io init failed"); return false; }
+
+  const int busId = 0;
+  for (uint8_t l = 0; l < lines; ++l) {
+    esp_rom_gpio_connect_out_signal(dataPins[l], PAR_I80_SIGNALS.buses[busId].data_sigs[l], false, false);
+    _pins[_pinCount++] = dataPins[l];
+  }
+  for (uint8_t l = 0; l < lines; ++l) {
+    if (l) {
+      esp_rom_gpio_pad_select_gpio(clkPins[l]);
+      gpio_set_direction((gpio_num_t)clkPins[l], GPIO_MODE_OUTPUT);
+    }
+    esp_rom_gpio_connect_out_signal(clkPins[l], PAR_I80_SIGNALS.buses[busId].wr_sig, false, false);
+    _pins[_pinCount++] = clkPins[l];
+  }
+  return true;
+}
+
+void ParallelOutput::clearLine(uint8_t line) {
+  uint8_t* p = words(line);
+  if (!p) return;
+  for (uint16_t i = 0; i < _leds; ++i, p += 4) { p[1] = p[2] = p[3] = 0; }
+}
+
+void ParallelOutput::show() {
+  if (!_io) return;
+  // Transpose into the idle buffer while the previous transfer may still run
+  const uint8_t* src[8] = { nullptr };
+  for (uint8_t l = 0; l < _lines; ++l) src[l] = _arm[l];
+  uint8_t* buf = _busBuf[_cur];
+  transposeStreams8(src, _lines, _armBytes, buf);
+  flush();
+  if (esp_lcd_panel_io_tx_color(_io, -1, buf, _armBytes * 8) == ESP_OK) _inFlight = true;
+  _cur ^= 1;
+  ++_shows;
+}
+
+void ParallelOutput::flush() {
+  if (!_inFlight) return;
+  xSemaphoreTake(_done, portMAX_DELAY);
+  _inFlight = false;
+}
+#endif
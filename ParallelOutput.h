@@ -0,0 +1,71 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Parallel SK9822 output: every arm on its own data line, one shared clock.
+//
+// Each arm keeps an ordinary SK9822 wire stream (LaneOutput::initWire layout,
+// no chaining).  show() bit-transposes the streams into 8-bit bus words and
+// hands them to the S3 LCD_CAM peripheral in i80 mode, whose DMA clocks all
+// arms out together: a 4-arm spoke takes one arm's transfer time and the CPU
+// is free while it runs.  The bus buffer is double-buffered.
+//
+// Only ESP32 builds have the engine; BitTranspose.h holds the portable part.
+
+#if defined(ESP_PLATFORM)
+#include <esp_lcd_panel_io.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+class ParallelOutput {
+public:
+  static const uint8_t MAX_LINES = 4;
+
+  ParallelOutput() { for (int v = 0; v < 256; ++v) _lvl[v] = (uint8_t)v; }
+  ~ParallelOutput();
+
+  // dataPins[lines]: one per arm.  clkPins[lines]: every pin gets the shared
+  // clock (the old per-post CLK pins).  Runs the transpose self-check first.
+  bool begin(const int* dataPins, const int* clkPins, uint8_t lines, uint16_t leds, uint32_t hz);
+
+  void setLevels(const uint8_t* lvl, uint8_t hdr) { memcpy(_lvl, lvl, sizeof(_lvl)); _hdr = hdr; }
+  void setPixelColor(uint8_t line, uint16_t i, uint8_t r, uint8_t g, uint8_t b) {
+    if (line >= _lines || i >= _leds) return;
+    uint8_t* p = _arm[line] + 4 + (size_t)i * 4;
+    p[0] = _hdr; p[1] = _lvl[b]; p[2] = _lvl[g]; p[3] = _lvl[r];
+  }
+  // LED words (hdr,B,G,R) of one arm, for kernels that write in place
+  uint8_t* words(uint8_t line) { return (line < _lines && _arm[line]) ? _arm[line] + 4 : nullptr; }
+  void clearLine(uint8_t line);
+  void clear() { for (uint8_t l = 0; l < _lines; ++l) clearLine(l); }
+
+  // Transpose all arms and start the DMA transfer
+  void show();
+  void flush();
+
+  uint16_t numPixels() const { return _leds; }
+  uint8_t  lines()     const { return _lines; }
+  uint32_t shows()     const { return _shows; }
+
+private:
+  static bool onDone(esp_lcd_panel_io_handle_t io, esp_lcd_panel_io_event_data_t* ev, void* ctx);
+
+  esp_lcd_i80_bus_handle_t  _bus = nullptr;
+  esp_lcd_panel_io_handle_t _io  = nullptr;
+  SemaphoreHandle_t         _done = nullptr;
+  bool      _inFlight = false;
+  uint8_t*  _arm[MAX_LINES] = { nullptr };
+  uint8_t*  _busBuf[2] = { nullptr, nullptr };
+  uint8_t   _cur   = 0;
+  uint8_t   _lines = 0;
+  uint16_t  _leds  = 0;
+  size_t    _armBytes = 0;
+  uint8_t   _lvl[256];
+  uint8_t   _hdr   = 0xFF;
+  uint32_t  _shows = 0;
+  int       _pins[2 * MAX_LINES];
+  uint8_t   _pinCount = 0;
+};
+#endif
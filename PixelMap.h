@@ -0,0 +1,32 @@
+#pragma once
+#include <stdint.h>
+
+// Sequence channel -> arm pixel mapping.  A source frame holds either one
+// spoke (arms x pixels x RGB) or every spoke of a revolution, sliced into
+// equal chPerSpoke blocks.  Rows are the frame byte offset of each pixel's R
+// channel (-1 = not in the file), the form the spoke kernels gather from.
+// Portable (no Arduino): shared by the player and the host bench.
+
+// Layout of a `chans`-channel source for arms x pixels on `spokes` spokes
+static inline void pixelFrameLayout(uint32_t chans, uint8_t arms, uint16_t pixels, uint16_t spokes,
+                                    bool& perSpokeFrame, uint32_t& chPerSpoke) {
+  const uint32_t expectedPerSpoke = (uint32_t)arms * (uint32_t)pixels * 3u;
+  perSpokeFrame = (chans == expectedPerSpoke);
+  chPerSpoke = expectedPerSpoke;
+  if (!perSpokeFrame && spokes > 0 && (chans % spokes) == 0) chPerSpoke = chans / spokes;
+}
+
+// Offsets of one (arm, slice) row into o[pixels]; false if any pixel is a hole.
+// xlate(absCh) -> frame index of an absolute channel, -1 when absent (sparse files).
+template <typename Xlate>
+static inline bool pixelRowOffsets(uint32_t armBase, uint16_t slice, uint32_t chPerSpoke, uint16_t pixels,
+                                   uint32_t chans, Xlate xlate, int32_t* o) {
+  const uint32_t base = armBase + (uint32_t)slice * chPerSpoke;
+  bool dense = true;
+  for (uint16_t i = 0; i < pixels; ++i) {
+    const int64_t idxR = xlate(base + (uint32_t)i * 3u);
+    o[i] = (idxR >= 0 && (idxR + 2) < (int64_t)chans) ? (int32_t)idxR : -1;
+    if (o[i] < 0) dense = false;
+  }
+  return dense;
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Spinner-native ("polar") sequence: an .fseq transcoded for one mapping, so a
+// frame load is one sequential read and a spoke paint is a copy.  Lives next
+// to its source as <name>.fseq.pov.
+//
+//   [0, 64)  header, little-endian, see polarEncodeHeader()
+//   [64, ..) frameCount frames of frameBytes = slices * arms * pixels * 4:
+//            spoke-major runs of lane-ordered SK9822 words (0xFF,B,G,R),
+//            colour order and arm reversal applied, full brightness
+//
+// The header names the source (uniqueId, frames, channels) and the mapping it
+// was built for (hash of start channels, spokes, arms, pixels, colour order
+// and arm reversal); the player only uses the file while all of them match.
+// Portable (no Arduino).
+
+static const char     POLAR_SUFFIX[]     = ".pov";
+static const uint8_t  POLAR_VERSION      = 1;
+static const uint16_t POLAR_HEADER_BYTES = 64;
+
+struct PolarHeader {
+  uint8_t  arms        = 0;
+  uint16_t slices      = 0;    // 1 when each source frame holds one spoke
+  uint16_t pixels      = 0;
+  uint8_t  stepTimeMs  = 0;
+  uint32_t frameCount  = 0;
+  uint32_t frameBytes  = 0;
+  uint32_t mapHash     = 0;
+  uint64_t srcUniqueId = 0;
+  uint32_t srcFrames   = 0;
+  uint32_t srcChannels = 0;
+  bool     complete    = false;   // written last; a partial file never matches
+};
+
+static inline uint32_t polarFrameBytes(uint8_t arms, uint16_t slices, uint16_t pixels) {
+  return (uint32_t)arms * slices * pixels * 4u;
+}
+
+static inline void polarPut16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static inline void polarPut32(uint8_t* p, uint32_t v) { polarPut16(p, (uint16_t)v); polarPut16(p + 2, (uint16_t)(v >> 16)); }
+static inline uint16_t polarGet16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static inline uint32_t polarGet32(const uint8_t* p) { return (uint32_t)polarGet16(p) | ((uint32_t)polarGet16(p + 2) << 16); }
+
+static inline void polarEncodeHeader(const PolarHeader& h, uint8_t out[POLAR_HEADER_BYTES]) {
+  memset(out, 0, POLAR_HEADER_BYTES);
+  memcpy(out, "LPOV", 4);
+  out[4] = POLAR_VERSION;
+  out[5] = h.arms;
+  out[6] = h.stepTimeMs;
+  out[7] = h.complete ? 1 : 0;
+  polarPut16(out + 8,  h.slices);
+  polarPut16(out + 10, h.pixels);
+  polarPut32(out + 12, h.frameCount);
+  polarPut32(out + 16, h.frameBytes);
+  polarPut32(out + 20, h.mapHash);
+  polarPut32(out + 24, (uint32_t)h.srcUniqueId);
+  polarPut32(out + 28, (uint32_t)(h.srcUniqueId >> 32));
+  polarPut32(out + 32, h.srcFrames);
+  polarPut32(out + 36, h.srcChannels);
+}
+
+// false on bad magic / version or a frame size that does not fit the geometry
+static inline bool polarDecodeHeader(const uint8_t in[POLAR_HEADER_BYTES], PolarHeader& h) {
+  if (memcmp(in, "LPOV", 4) != 0 || in[4] != POLAR_VERSION) return false;
+  h.arms        = in[5];
+  h.stepTimeMs  = in[6];
+  h.complete    = in[7] == 1;
+  h.slices      = polarGet16(in + 8);
+  h.pixels      = polarGet16(in + 10);
+  h.frameCount  = polarGet32(in + 12);
+  h.frameBytes  = polarGet32(in + 16);
+  h.mapHash     = polarGet32(in + 20);
+  h.srcUniqueId = (uint64_t)polarGet32(in + 24) | ((uint64_t)polarGet32(in + 28) << 32);
+  h.srcFrames   = polarGet32(in + 32);
+  h.srcChannels = polarGet32(in + 36);
+  return h.arms && h.slices && h.pixels && h.frameBytes == polarFrameBytes(h.arms, h.slices, h.pixels);
+}
+
+// FNV-1a (mapping hash, SD card key)
+static const uint32_t FNV1A_INIT = 2166136261u;
+static inline uint32_t fnv1a(uint32_t h, const void* data, size_t n) {
+  const uint8_t* p = (const uint8_t*)data;
+  for (size_t i = 0; i < n; ++i) { h ^= p[i]; h *= 16777619u; }
+  return h;
+}
+
+// Apply a brightness/gamma table to n stored words (identity levels are a memcpy)
+static inline void polarApplyLevels(const uint8_t* src, uint16_t n, const uint8_t* lvl, uint8_t hdr, uint8_t* dst) {
+  for (uint16_t i = 0; i < n; ++i, src += 4, dst += 4) {
+    dst[0] = hdr;
+    dst[1] = lvl[src[1]];
+    dst[2] = lvl[src[2]];
+    dst[3] = lvl[src[3]];
+  }
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <math.h>
+#include <stdint.h>
+#include "SpokeScheduler.h"   // usReached()
+
+// Synthetic rotor: generates Hall pulse times so the real sync -> schedule ->
+// paint -> commit path can be timed with the rotor standing still.  Either a
+// constant or linearly ramping speed (with optional jitter and dropped
+// pulses), or the intervals of a recorded sync trace played back in a loop.
+// Pure bookkeeping on the wrapping microsecond timeline; no Arduino.
+
+struct RotationSimCfg {
+  float    rpm       = 600.0f;   // start speed
+  float    rpmEnd    = 0.0f;     // 0 = constant; otherwise ramp to this over rampMs
+  uint32_t rampMs    = 0;
+  uint32_t jitterUs  = 0;        // +/- uniform noise on every pulse time
+  uint8_t  dropEvery = 0;        // swallow every Nth pulse (0 = never)
+  uint8_t  ppr       = 1;        // pulses per revolution, as the real sensor
+  const uint32_t* trace = nullptr;  // recorded sync times; overrides rpm when set
+  uint32_t traceLen  = 0;
+};
+
+class RotationSim {
+public:
+  void start(uint32_t nowUs, const RotationSimCfg& cfg) {
+    _cfg = cfg;
+    if (!_cfg.ppr) _cfg.ppr = 1;
+    _t0 = nowUs; _next = nowUs; _pulses = 0; _traceIdx = 0; _active = true;
+    _rng = 0x9E3779B9u ^ nowUs;
+    advance();
+  }
+  void stop() { _active = false; }
+  bool active() const { return _active; }
+
+  // Nominal time of the next pulse (before jitter)
+  uint32_t nextUs() const { return _next; }
+  uint32_t pulses() const { return _pulses; }
+
+  // Next pulse whose time has come; false if none yet
+  bool due(uint32_t nowUs, uint32_t& pulseUs) {
+    while (_active && usReached(nowUs, _next)) {
+      const uint32_t t = _next + _jitter;
+      const bool drop = _cfg.dropEvery && ((_pulses + 1) % _cfg.dropEvery) == 0;
+      ++_pulses;
+      advance();
+      if (drop) continue;
+      pulseUs = t;
+      return true;
+    }
+    return false;
+  }
+
+  // Current simulated speed
+  float rpm() const {
+    if (_cfg.trace || !_cfg.rpmEnd || !_cfg.rampMs) return _cfg.rpm;
+    const float u = (float)(uint32_t)(_next - _t0) / (1000.0f * (float)_cfg.rampMs);
+    return u >= 1.0f ? _cfg.rpmEnd : _cfg.rpm + (_cfg.rpmEnd - _cfg.rpm) * u;
+  }
+
+private:
+  void advance() {
+    uint32_t dt;
+    if (_cfg.trace && _cfg.traceLen >= 2) {
+      // Recorded syncs are one per revolution; spread them over ppr pulses
+      const uint32_t i = _traceIdx / _cfg.ppr;
+      const uint32_t a = i % (_cfg.traceLen - 1);
+      dt = (_cfg.trace[a + 1] - _cfg.trace[a]) / _cfg.ppr;
+      if (++_traceIdx >= (_cfg.traceLen - 1) * _cfg.ppr) _traceIdx = 0;
+    } else {
+      const float r = rpm();
+      dt = (uint32_t)lroundf(60000000.0f / ((r > 1.0f ? r : 1.0f) * _cfg.ppr));
+    }
+    _next += dt ? dt : 1;
+    _jitter = 0;
+    if (_cfg.jitterUs) {
+      _rng ^= _rng << 13; _rng ^= _rng >> 17; _rng ^= _rng << 5;   // xorshift32
+      _jitter = (uint32_t)((int32_t)(_rng % (2 * _cfg.jitterUs + 1)) - (int32_t)_cfg.jitterUs);
+    }
+  }
+
+  RotationSimCfg _cfg;
+  uint32_t _t0 = 0, _next = 0, _jitter = 0, _pulses = 0, _traceIdx = 0, _rng = 1;
+  bool     _active = false;
+};
@@ -4,9 +4,13 @@
 #include <Update.h>
 #include <WebServer.h>
 #include <Preferences.h>
+#include <esp_heap_caps.h>
+#include "freertos/queue.h"
+#include "freertos/task.h"
 
 #include "HtmlUtils.h"
 #include "WebPages.h"
+#include "PolarFile.h"
 
 // Hardware pins
 const int PIN_SD_CLK = 10;
@@ -23,16 +27,19 @@ static const char* const SETTINGS_FILE = "/config/settings.ini";
 static const char* const OTA_FILE      = "/firmware.bin";
 static const char* const OTA_FAIL_FILE = "/firmware.failed";
 
-static const uint32_t SD_FREQ_OPTIONS[] = { 8000, 4000, 2000, 1000, 400 };
+// 40 MHz is SD high-speed mode (switched by the driver when the card supports it), 20 MHz default speed
+static const uint32_t SD_FREQ_OPTIONS[] = { 40000, 20000, 8000, 4000, 2000, 1000, 400 };
 static const size_t   SD_FREQ_OPTION_COUNT = sizeof(SD_FREQ_OPTIONS) / sizeof(SD_FREQ_OPTIONS[0]);
+static const uint32_t SD_FREQ_SAFE_KHZ     = 8000;   // first mount on auto, and the calibration fallback
 
 SemaphoreHandle_t g_sdMutex = nullptr;
 SdBusPreference   g_sdPreferredBusWidth = SD_BUS_AUTO;
-uint32_t          g_sdBaseFreqKHz       = 8000;
+uint32_t          g_sdBaseFreqKHz       = SD_FREQ_AUTO_KHZ;
 uint32_t          g_sdFreqKHz           = 8000;
 int               g_sdFailStreak        = 0;
 bool              g_sdReady             = false;
 uint8_t           g_sdBusWidth          = 0;
+SdStats           g_sdStats;
 
 // Externs from main sketch
 extern WebServer server;
@@ -63,6 +70,8 @@ extern String g_currentPath;
 
 extern bool openFseq(const String& path, String& why);
 extern void feedWatchdog();
+extern bool playbackNeedsSd();
+extern void seqCacheForget(const String& path);
 
 namespace {
 
@@ -163,6 +172,7 @@ SdBusPreference sanitizeSdMode(uint8_t mode) {
 }
 
 bool isValidSdFreq(uint32_t freq) {
+  if (freq == SD_FREQ_AUTO_KHZ) return true;
   for (size_t i = 0; i < SD_FREQ_OPTION_COUNT; ++i) {
     if (SD_FREQ_OPTIONS[i] == freq) return true;
   }
@@ -170,7 +180,7 @@ bool isValidSdFreq(uint32_t freq) {
 }
 
 uint32_t sanitizeSdFreq(uint32_t freq) {
-  return isValidSdFreq(freq) ? freq : SD_FREQ_OPTIONS[0];
+  return isValidSdFreq(freq) ? freq : SD_FREQ_AUTO_KHZ;
 }
 
 uint32_t nextLowerSdFreq(uint32_t freq) {
@@ -348,6 +358,201 @@ void sd_preflight() {
                 PIN_SD_D2,  digitalRead(PIN_SD_D2),
                 PIN_SD_D3,  digitalRead(PIN_SD_D3));
 }
+
+bool sdBeginLocked(uint8_t mode, uint32_t freqKHz) {
+  bool ok;
+  if (mode == 4) {
+    SD_MMC.setPins(PIN_SD_CLK, PIN_SD_CMD, PIN_SD_D0, PIN_SD_D1, PIN_SD_D2, PIN_SD_D3);
+    ok = SD_MMC.begin("/sdcard", false /*4-bit*/, false /*no-format*/, freqKHz);
+  } else {
+    SD_MMC.setPins(PIN_SD_CLK, PIN_SD_CMD, PIN_SD_D0, -1, -1, -1);
+    ok = SD_MMC.begin("/sdcard", true /*1-bit*/, false /*no-format*/, freqKHz);
+  }
+  ++g_sdStats.mounts;
+  if (!ok) ++g_sdStats.mountFails;
+  g_sdBusWidth = ok ? mode : 0;
+  if (ok) g_sdFreqKHz = freqKHz;
+  return ok;
+}
+
+/* ---------------- Bus calibration ---------------- */
+// With the clock on auto, each card is benchmarked once: at every width and
+// clock tier a test file is written and read back (sequential, then random
+// 4 KB), and the fastest setting that round-trips it intact is kept in NVS
+// under the card's key.  SD_MMC does not expose the CID, so the key is
+// the CSD capacity plus the FAT volume serial.  If recoverSd() later has to
+// step the clock down, the lower clock becomes the card's setting.
+const char*    SD_CAL_FILE       = "/config/sdcal.bin";
+const size_t   SD_CAL_BYTES      = 512 * 1024;
+const size_t   SD_CAL_CHUNK      = 32 * 1024;
+const uint16_t SD_CAL_RAND_READS = 64;
+const size_t   SD_CAL_RAND_BYTES = 4096;
+const uint32_t SD_CAL_TIERS[]    = { 40000, 20000, SD_FREQ_SAFE_KHZ };
+const uint8_t  SD_CAL_MAX        = 6;     // widths x tiers
+
+struct SdCalResult { uint8_t width; uint32_t freqKHz; bool pass; uint32_t writeUs; uint32_t seqUs; uint32_t randUs; };
+SdCalResult g_sdCal[SD_CAL_MAX];
+uint8_t     g_sdCalCount = 0;
+String      g_sdCardKey;                // NVS key of the mounted card ("" = unknown)
+// A card without a key (unreadable boot sector, GPT, superfloppy) cannot be
+// stored in NVS; its result is kept for the session so remounts reuse it
+bool        g_sdUnkeyedCal     = false;
+uint32_t    g_sdUnkeyedSetting = 0;
+
+inline uint32_t calPack(uint8_t width, uint32_t freqKHz) { return ((uint32_t)width << 24) | (freqKHz & 0xFFFFFF); }
+inline uint8_t  calWidth(uint32_t v) { return (uint8_t)(v >> 24); }
+inline uint32_t calFreq(uint32_t v)  { return v & 0xFFFFFF; }
+
+// Test pattern: every word encodes its own position, so any block can be checked
+inline uint32_t calWord(uint32_t i) { return (i * 2654435761u) ^ 0x5AC3E1F0u; }
+void calFill(uint8_t* buf, size_t off, size_t n) {
+  uint32_t* w = (uint32_t*)buf;
+  for (size_t i = 0; i < n / 4; ++i) w[i] = calWord((uint32_t)(off / 4 + i));
+}
+bool calCheck(const uint8_t* buf, size_t off, size_t n) {
+  const uint32_t* w = (const uint32_t*)buf;
+  for (size_t i = 0; i < n / 4; ++i) if (w[i] != calWord((uint32_t)(off / 4 + i))) return false;
+  return true;
+}
+
+inline uint32_t le32(const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+// NVS key for the mounted card, "" if its boot sector cannot be read (sec: 512 B)
+String sdCardKeyLocked(uint8_t* sec) {
+  if (!SD_MMC.readRAW(sec, 0)) return "";
+  if (sec[0] != 0xEB && sec[0] != 0xE9) {   // MBR: first partition's boot sector
+    const uint32_t lba = le32(sec + 0x1C6);
+    if (!lba || !SD_MMC.readRAW(sec, lba)) return "";
+  }
+  if (sec[510] != 0x55 || sec[511] != 0xAA) return "";
+  uint32_t vsn;
+  if (memcmp(sec + 3, "EXFAT   ", 8) == 0)    vsn = le32(sec + 0x64);
+  else if (sec[0x16] == 0 && sec[0x17] == 0) vsn = le32(sec + 0x43);   // FAT32 (no 16-bit FAT size)
+  else                                       vsn = le32(sec + 0x27);
+  const uint64_t sectors = (uint64_t)SD_MMC.numSectors();
+  uint32_t h = fnv1a(FNV1A_INIT, &sectors, sizeof(sectors));
+  h = fnv1a(h, &vsn, sizeof(vsn));
+  char key[12];
+  snprintf(key, sizeof(key), "sd%08lx", (unsigned long)h);
+  return String(key);
+}
+
+// Write the test file at the mounted setting
+bool calWriteLocked(uint8_t* buf, SdCalResult& r) {
+  File f = SD_MMC.open(SD_CAL_FILE, FILE_WRITE);
+  if (!f) return false;
+  bool ok = true;
+  const uint32_t t0 = micros();
+  for (size_t off = 0; ok && off < SD_CAL_BYTES; off += SD_CAL_CHUNK) {
+    calFill(buf, off, SD_CAL_CHUNK);
+    ok = f.write(buf, SD_CAL_CHUNK) == SD_CAL_CHUNK;
+  }
+  f.close();
+  r.writeUs = micros() - t0;
+  return ok;
+}
+
+// Read the test file back at the mounted setting
+bool calBenchLocked(uint8_t* buf, SdCalResult& r) {
+  File f = SD_MMC.open(SD_CAL_FILE, FILE_READ);
+  if (!f) return false;
+  bool ok = true;
+  uint32_t t0 = micros();
+  for (size_t off = 0; ok && off < SD_CAL_BYTES; off += SD_CAL_CHUNK)
+    ok = f.read(buf, SD_CAL_CHUNK) == SD_CAL_CHUNK && calCheck(buf, off, SD_CAL_CHUNK);
+  r.seqUs = micros() - t0;
+  uint32_t rng = 0x2545F491u;
+  t0 = micros();
+  for (uint16_t i = 0; ok && i < SD_CAL_RAND_READS; ++i) {
+    rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+    const size_t off = (rng % (SD_CAL_BYTES / SD_CAL_RAND_BYTES)) * SD_CAL_RAND_BYTES;
+    ok = f.seek(off, SeekSet) && f.read(buf, SD_CAL_RAND_BYTES) == SD_CAL_RAND_BYTES && calCheck(buf, off, SD_CAL_RAND_BYTES);
+  }
+  r.randUs = micros() - t0;
+  f.close();
+  return ok;
+}
+
+// Mounted at the safe tier on entry; unmounted on return.  Each candidate
+// writes the pattern and reads it back at its own setting.  Packed best
+// setting, 0 if none passed (or the settings dir could not be made).
+uint32_t calibrateLocked(uint8_t* buf) {
+  if (!ensureSettingsDirLocked()) { SD_MMC.end(); return 0; }
+
+  ++g_sdStats.calibrations;
+  g_sdCalCount = 0;
+  uint8_t widths[2] = { 4, 1 };
+  uint8_t widthCount = 2;
+  if (g_sdPreferredBusWidth != SD_BUS_AUTO) { widths[0] = (uint8_t)g_sdPreferredBusWidth; widthCount = 1; }
+
+  int best = -1;
+  for (uint8_t wi = 0; wi < widthCount; ++wi) {
+    for (uint32_t tier : SD_CAL_TIERS) {
+      feedWatchdog();
+      SD_MMC.end(); delay(2);
+      SdCalResult& r = g_sdCal[g_sdCalCount];
+      r = { widths[wi], tier, false, 0, 0, 0 };
+      const bool mounted = sdBeginLocked(widths[wi], tier);
+      const bool wrote = mounted && calWriteLocked(buf, r);
+      r.pass = wrote && calBenchLocked(buf, r);
+      if (mounted && !r.pass) ++g_sdStats.calVerifyFails;
+      Serial.printf("[SD] Calibrate %ubit @ %lu kHz: %s wr=%lu us seq=%lu us rand=%lu us\n", (unsigned)r.width, (unsigned long)tier,
+                    r.pass ? "PASS" : (wrote ? "BAD READBACK" : (mounted ? "WRITE FAIL" : "NO MOUNT")),
+                    (unsigned long)r.writeUs, (unsigned long)r.seqUs, (unsigned long)r.randUs);
+      const uint8_t idx = g_sdCalCount++;
+      if (!r.pass) continue;
+      // Slower tiers of this width cannot beat it
+      if (best < 0 || r.seqUs + r.randUs < g_sdCal[best].seqUs + g_sdCal[best].randUs) best = idx;
+      break;
+    }
+  }
+  SD_MMC.end();
+  g_sdBusWidth = 0;
+  return best < 0 ? 0 : calPack(g_sdCal[best].width, g_sdCal[best].freqKHz);
+}
+
+bool g_sdCalibrated = false;   // current mount uses the card's stored setting
+
+// Auto clock, card mounted at the safe tier (or at a clock recoverSd() lowered):
+// move to the card's stored setting, calibrating first if it has none.
+void sdApplyCardSettingLocked() {
+  uint8_t* buf = (uint8_t*)heap_caps_aligned_alloc(64, SD_CAL_CHUNK, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+  if (!buf) buf = (uint8_t*)heap_caps_aligned_alloc(64, SD_CAL_CHUNK, MALLOC_CAP_8BIT);
+  if (!buf) return;
+  const uint8_t  w0 = g_sdBusWidth;
+  const uint32_t f0 = g_sdFreqKHz;
+  g_sdCardKey = sdCardKeyLocked(buf);
+  const bool keyed = g_sdCardKey.length() != 0;
+  uint32_t setting = keyed ? prefs.getUInt(g_sdCardKey.c_str(), 0) : g_sdUnkeyedSetting;
+  bool known = keyed ? setting != 0 : g_sdUnkeyedCal;
+  if (setting && g_sdPreferredBusWidth != SD_BUS_AUTO && calWidth(setting) != (uint8_t)g_sdPreferredBusWidth) { setting = 0; known = false; }
+  if (setting && g_sdFailStreak >= 2 && f0 < calFreq(setting)) {
+    // recoverSd() stepped the clock down: the stored one failed in use
+    setting = calPack(w0, f0);
+    if (keyed) prefs.putUInt(g_sdCardKey.c_str(), setting);
+    else g_sdUnkeyedSetting = setting;
+    ++g_sdStats.demotions;
+    Serial.printf("[SD] Card %s demoted to %ubit @ %lu kHz\n", keyed ? g_sdCardKey.c_str() : "?", (unsigned)w0, (unsigned long)f0);
+  }
+  bool calibrated = false;
+  if (!known) {
+    setting = calibrateLocked(buf);
+    calibrated = true;
+    if (setting && keyed) prefs.putUInt(g_sdCardKey.c_str(), setting);
+    if (!keyed) { g_sdUnkeyedCal = true; g_sdUnkeyedSetting = setting; }   // 0 = stay at the safe tier
+  }
+  if (calibrated || calWidth(setting) != w0 || calFreq(setting) != f0) {
+    SD_MMC.end(); delay(2);
+    bool ok = setting && sdBeginLocked(calWidth(setting), calFreq(setting));
+    if (!ok) { SD_MMC.end(); delay(2); sdBeginLocked(w0, f0); }
+  }
+  if (calibrated && g_sdBusWidth) SD_MMC.remove(SD_CAL_FILE);
+  g_sdCalibrated = setting && g_sdBusWidth == calWidth(setting) && g_sdFreqKHz == calFreq(setting);
+  Serial.printf("[SD] Card %s: %ubit @ %lu kHz (%s)\n", g_sdCardKey.length() ? g_sdCardKey.c_str() : "?",
+                (unsigned)g_sdBusWidth, (unsigned long)g_sdFreqKHz,
+                g_sdCalibrated ? (calibrated ? "calibrated" : "stored") : "safe");
+  heap_caps_free(buf);
+}
 }
 
 bool mountSdmmc() {
@@ -355,8 +560,11 @@ bool mountSdmmc() {
     Serial.println("[SD] mount lock timeout");
     return false;
   }
-  g_sdFreqKHz = sanitizeSdFreq(g_sdFreqKHz);
   g_sdBaseFreqKHz = sanitizeSdFreq(g_sdBaseFreqKHz);
+  const bool autoFreq = (g_sdBaseFreqKHz == SD_FREQ_AUTO_KHZ);
+  // g_sdFreqKHz is the clock actually mounted with; auto starts from the safe tier
+  if (g_sdFreqKHz == SD_FREQ_AUTO_KHZ || !isValidSdFreq(g_sdFreqKHz))
+    g_sdFreqKHz = autoFreq ? SD_FREQ_SAFE_KHZ : g_sdBaseFreqKHz;
 
   uint8_t attempts[2] = { 4, 1 };
   size_t attemptCount = 0;
@@ -372,27 +580,50 @@ bool mountSdmmc() {
     feedWatchdog();
     uint8_t mode = attempts[i];
     if (i > 0) { SD_MMC.end(); delay(2); }
-    if (mode == 4) {
-      SD_MMC.setPins(PIN_SD_CLK, PIN_SD_CMD, PIN_SD_D0, PIN_SD_D1, PIN_SD_D2, PIN_SD_D3);
-      ok = SD_MMC.begin("/sdcard", false /*4-bit*/, false /*no-format*/, g_sdFreqKHz);
-    } else {
-      SD_MMC.setPins(PIN_SD_CLK, PIN_SD_CMD, PIN_SD_D0, -1, -1, -1);
-      ok = SD_MMC.begin("/sdcard", true /*1-bit*/, false /*no-format*/, g_sdFreqKHz);
-    }
+    ok = sdBeginLocked(mode, g_sdFreqKHz);
     Serial.printf("[SD] Mounted (%ubit request=%u) @ %lu kHz: %s\n",
                   (unsigned)mode, (unsigned)g_sdPreferredBusWidth,
                   (unsigned long)g_sdFreqKHz, ok?"OK":"FAIL");
-    if (ok) { g_sdBusWidth = mode; break; }
+    if (ok) break;
   }
+  g_sdCalibrated = false;
+  if (ok && autoFreq) { sdApplyCardSettingLocked(); ok = g_sdBusWidth != 0; }
   SD_UNLOCK();
   g_sdReady = ok;
   return ok;
 }
 
 namespace {
-File   g_uploadFile;
-String g_uploadFilename;
-size_t g_uploadBytes = 0;
+File     g_uploadFile;
+String   g_uploadFilename;
+size_t   g_uploadBytes = 0;
+uint32_t g_uploadStartMs = 0;
+uint32_t g_uploadMs = 0;
+
+// Raw-body (PUT) uploads: the HTTP handler fills large DMA-capable buffers and
+// a writer task puts each on the card in one write, holding the SD lock per
+// buffer and standing back while playback is short of frames.  The file is
+// grown to Content-Length before the first byte so its clusters are allocated
+// in one run instead of one at a time.
+const size_t     UPLOAD_BUF_BYTES = 32 * 1024;   // whole sectors: FatFs writes straight from it
+const uint8_t    UPLOAD_BUFS      = 3;
+const BaseType_t UPLOAD_CORE      = 0;           // I/O core; the render core is left alone
+const UBaseType_t UPLOAD_TASK_PRIO = 1;          // below the frame producer
+const uint32_t   UPLOAD_YIELD_MS  = 20;          // longest wait for playback per buffer
+
+struct UploadChunk { uint8_t* buf; size_t len; };   // len 0 = end of upload
+
+QueueHandle_t     g_upFree    = nullptr;   // empty buffers
+QueueHandle_t     g_upFull    = nullptr;   // buffers waiting for the writer
+SemaphoreHandle_t g_upDrained = nullptr;   // writer reached the end marker
+TaskHandle_t      g_upTask    = nullptr;
+uint8_t*          g_upBufs[UPLOAD_BUFS] = { nullptr };
+uint8_t*          g_upCur     = nullptr;   // buffer being filled (HTTP side)
+size_t            g_upCurLen  = 0;
+size_t            g_upExpect  = 0;         // Content-Length
+volatile size_t   g_upWritten = 0;
+volatile bool     g_upError   = false;
+int               g_upStatus  = 0;         // HTTP status for the done handler (0 = ok)
 }
 
 static void listFseqInDir_locked(const char* path, String& optionsHtml, uint8_t depth = 0) {
@@ -540,7 +771,10 @@ void handleDelete() {
     if (f.isDirectory()) { f.close(); ok = SD_MMC.rmdir(path); }
     else { f.close(); ok = SD_MMC.remove(path); }
   }
+  // A native twin goes with its source
+  if (ok && isFseqName(path) && SD_MMC.exists(path + POLAR_SUFFIX)) SD_MMC.remove(path + POLAR_SUFFIX);
   SD_UNLOCK();
+  if (ok) seqCacheForget(path);
   server.sendHeader("Location", back);
   server.send(ok?302:500, "text/plain", ok?"Deleted":"Delete failed");
 }
@@ -574,7 +808,9 @@ void handleRename() {
 
   if (!g_sdMutex || !SD_LOCK(pdMS_TO_TICKS(2000))) { server.sendHeader("Location", back); server.send(302,"text/plain","SD busy"); return; }
   bool ok = SD_MMC.rename(p, dst);
+  if (ok && SD_MMC.exists(p + POLAR_SUFFIX)) SD_MMC.rename(p + POLAR_SUFFIX, dst + POLAR_SUFFIX);
   SD_UNLOCK();
+  if (ok) { seqCacheForget(p); seqCacheForget(dst); }
 
   server.sendHeader("Location", back);
   server.send(ok?302:500, "text/plain", ok?"Renamed":"Rename failed");
@@ -584,6 +820,8 @@ void handleUploadData() {
   HTTPUpload& up = server.upload();
   if (up.status == UPLOAD_FILE_START) {
     g_uploadBytes = 0;
+    g_uploadStartMs = millis();
+    g_uploadMs = 0;
 
     String dir = server.hasArg("dir") ? server.arg("dir") : "/";
     if (dir.indexOf("..") >= 0) dir = "/";
@@ -604,6 +842,7 @@ void handleUploadData() {
         Serial.printf("[UPLOAD] Target dir missing: %s\n", dir.c_str());
       } else {
         if (SD_MMC.exists(g_uploadFilename)) SD_MMC.remove(g_uploadFilename);
+        seqCacheForget(g_uploadFilename);
         g_uploadFile = SD_MMC.open(g_uploadFilename, FILE_WRITE);
         Serial.printf("[UPLOAD] START %s\n", g_uploadFilename.c_str());
       }
@@ -621,7 +860,8 @@ void handleUploadData() {
   } else if (up.status == UPLOAD_FILE_END) {
     if (g_uploadFile) {
       if (g_sdMutex && SD_LOCK(pdMS_TO_TICKS(2000))) { g_uploadFile.close(); SD_UNLOCK(); }
-      Serial.printf("[UPLOAD] DONE %s (%u bytes)\n", g_uploadFilename.c_str(), (unsigned)g_uploadBytes);
+      g_uploadMs = millis() - g_uploadStartMs;
+      Serial.printf("[UPLOAD] DONE %s (%u bytes, %lu ms)\n", g_uploadFilename.c_str(), (unsigned)g_uploadBytes, (unsigned long)g_uploadMs);
     } else {
       Serial.println("[UPLOAD] Aborted/invalid file");
     }
@@ -645,7 +885,174 @@ void handleUploadDone() {
     server.send(500, "text/html", WebPages::uploadFailurePage(back));
     return;
   }
-  server.send(200, "text/html", WebPages::uploadSuccessPage(back, g_uploadFilename, g_uploadBytes));
+  server.send(200, "text/html", WebPages::uploadSuccessPage(back, g_uploadFilename, g_uploadBytes, g_uploadMs));
+}
+
+/* ---------------- Raw-body upload (PUT /upload?path=/show.fseq) ---------------- */
+namespace {
+void uploadWriterTask(void*) {
+  for (;;) {
+    UploadChunk c;
+    if (xQueueReceive(g_upFull, &c, portMAX_DELAY) != pdTRUE) continue;
+    if (!c.len) { xSemaphoreGive(g_upDrained); continue; }
+    if (!g_upError) {
+      // Let the frame producer refill first if playback is running low
+      for (uint32_t waited = 0; waited < UPLOAD_YIELD_MS && playbackNeedsSd(); ++waited) vTaskDelay(pdMS_TO_TICKS(1));
+      if (g_sdMutex && SD_LOCK(pdMS_TO_TICKS(2000))) {
+        if (g_uploadFile.write(c.buf, c.len) != c.len) g_upError = true;
+        SD_UNLOCK();
+        g_upWritten += c.len;
+      } else {
+        g_upError = true;
+      }
+    }
+    xQueueSend(g_upFree, &c.buf, portMAX_DELAY);
+  }
+}
+
+bool rawUploadInit() {
+  if (!g_upFree) {
+    g_upFree    = xQueueCreate(UPLOAD_BUFS, sizeof(uint8_t*));
+    g_upFull    = xQueueCreate(UPLOAD_BUFS + 1, sizeof(UploadChunk));
+    g_upDrained = xSemaphoreCreateBinary();
+    if (!g_upFree || !g_upFull || !g_upDrained) return false;
+  }
+  xQueueReset(g_upFree);
+  xQueueReset(g_upFull);
+  xSemaphoreTake(g_upDrained, 0);
+  for (uint8_t i = 0; i < UPLOAD_BUFS; ++i) {
+    if (!g_upBufs[i]) {
+      g_upBufs[i] = (uint8_t*)heap_caps_aligned_alloc(64, UPLOAD_BUF_BYTES, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+      if (!g_upBufs[i]) g_upBufs[i] = (uint8_t*)heap_caps_aligned_alloc(64, UPLOAD_BUF_BYTES, MALLOC_CAP_8BIT);
+      if (!g_upBufs[i]) return false;
+    }
+    xQueueSend(g_upFree, &g_upBufs[i], 0);
+  }
+  if (!g_upTask && xTaskCreatePinnedToCore(uploadWriterTask, "upload", 4096, nullptr, UPLOAD_TASK_PRIO, &g_upTask, UPLOAD_CORE) != pdPASS) {
+    g_upTask = nullptr;
+    return false;
+  }
+  return true;
+}
+
+// Buffers are only held for the length of an upload
+void rawUploadFreeBufs() {
+  if (g_upFree) xQueueReset(g_upFree);
+  for (uint8_t i = 0; i < UPLOAD_BUFS; ++i) {
+    if (g_upBufs[i]) { heap_caps_free(g_upBufs[i]); g_upBufs[i] = nullptr; }
+  }
+  g_upCur = nullptr;
+}
+
+// Hand the current buffer to the writer and take an empty one (HTTP side)
+bool rawUploadPush(bool last) {
+  if (g_upCur && g_upCurLen) {
+    UploadChunk c = { g_upCur, g_upCurLen };
+    xQueueSend(g_upFull, &c, portMAX_DELAY);
+    g_upCur = nullptr;
+  }
+  g_upCurLen = 0;
+  if (last) {
+    UploadChunk end = { nullptr, 0 };
+    xQueueSend(g_upFull, &end, portMAX_DELAY);
+    return xSemaphoreTake(g_upDrained, pdMS_TO_TICKS(30000)) == pdTRUE;
+  }
+  if (!g_upCur) {
+    while (xQueueReceive(g_upFree, &g_upCur, pdMS_TO_TICKS(1000)) != pdTRUE) {
+      feedWatchdog();
+      if (g_upError) return false;
+    }
+  }
+  return true;
+}
+
+// Drain the writer and close the file; drop it unless every declared byte
+// made it to the card
+void rawUploadFinish(bool ok) {
+  if (!ok) g_upError = true;   // the writer skips whatever is still queued
+  const bool drained = rawUploadPush(true);
+  ok = ok && drained && !g_upError && g_upWritten == g_upExpect;
+  if (g_sdMutex && SD_LOCK(pdMS_TO_TICKS(5000))) {
+    g_uploadFile.close();
+    if (!ok) SD_MMC.remove(g_uploadFilename);
+    SD_UNLOCK();
+  }
+  if (drained) rawUploadFreeBufs();   // else the writer may still hold one
+  g_uploadBytes = g_upWritten;
+  g_uploadMs = millis() - g_uploadStartMs;
+  if (!ok && !g_upStatus) g_upStatus = 500;
+  Serial.printf("[UPLOAD] PUT %s %s (%u of %u bytes, %lu ms)\n", g_uploadFilename.c_str(), ok ? "DONE" : "FAILED",
+                (unsigned)g_upWritten, (unsigned)g_upExpect, (unsigned long)g_uploadMs);
+}
+} // namespace
+
+void handleRawUploadData() {
+  HTTPRaw& raw = server.raw();
+  if (raw.status == RAW_START) {
+    g_uploadBytes = 0; g_uploadMs = 0; g_uploadStartMs = millis();
+    g_upWritten = 0; g_upError = false; g_upStatus = 0; g_upCurLen = 0;
+    g_upExpect = server.clientContentLength();
+
+    g_uploadFilename = server.hasArg("path") ? server.arg("path") : "";
+    if (g_uploadFilename.indexOf("..") >= 0) g_uploadFilename = "";
+    if (g_uploadFilename.length() && !g_uploadFilename.startsWith("/")) g_uploadFilename = "/" + g_uploadFilename;
+    if (!isFseqName(g_uploadFilename)) { g_upStatus = 415; return; }
+    if (!g_upExpect || g_upExpect == CONTENT_LENGTH_UNKNOWN) { g_upStatus = 411; return; }
+    if (!rawUploadInit()) { rawUploadFreeBufs(); g_upStatus = 503; return; }
+
+    if (!g_sdMutex || !SD_LOCK(pdMS_TO_TICKS(5000))) { rawUploadFreeBufs(); g_upStatus = 503; return; }
+    const String dir = dirnameOf(g_uploadFilename);
+    File d = SD_MMC.open(dir);
+    const bool okdir = d && d.isDirectory(); if (d) d.close();
+    const char* why = nullptr;
+    if (!okdir) {
+      g_upStatus = 404; why = "target dir missing";
+    } else {
+      if (SD_MMC.exists(g_uploadFilename)) SD_MMC.remove(g_uploadFilename);
+      seqCacheForget(g_uploadFilename);
+      g_uploadFile = SD_MMC.open(g_uploadFilename, FILE_WRITE);
+      // Preallocate: seeking past the end and writing the last byte extends the
+      // cluster chain to the full size at once, so a failure there means no room
+      if (!g_uploadFile) {
+        g_upStatus = 500; why = "open failed";
+      } else if (!(g_uploadFile.seek(g_upExpect - 1, SeekSet) && g_uploadFile.write((uint8_t)0) == 1 &&
+                   g_uploadFile.seek(0, SeekSet))) {
+        g_uploadFile.close();
+        SD_MMC.remove(g_uploadFilename);
+        g_upStatus = 507; why = "no room";
+      }
+    }
+    SD_UNLOCK();
+    if (why) {
+      rawUploadFreeBufs();
+      Serial.printf("[UPLOAD] PUT %s (%u bytes): %s\n", g_uploadFilename.c_str(), (unsigned)g_upExpect, why);
+      return;
+    }
+    Serial.printf("[UPLOAD] PUT START %s (%u bytes)\n", g_uploadFilename.c_str(), (unsigned)g_upExpect);
+    if (!rawUploadPush(false)) rawUploadFinish(false);
+  } else if (raw.status == RAW_WRITE) {
+    if (!g_upCur || g_upStatus) return;
+    if (g_upError) { rawUploadFinish(false); return; }   // card full / write error: stop early
+    const uint8_t* p = raw.buf;
+    size_t n = raw.currentSize;
+    while (n) {
+      const size_t take = (n < UPLOAD_BUF_BYTES - g_upCurLen) ? n : UPLOAD_BUF_BYTES - g_upCurLen;
+      memcpy(g_upCur + g_upCurLen, p, take);
+      g_upCurLen += take; p += take; n -= take;
+      if (g_upCurLen == UPLOAD_BUF_BYTES && !rawUploadPush(false)) { rawUploadFinish(false); return; }
+    }
+    feedWatchdog();
+  } else if (raw.status == RAW_END || raw.status == RAW_ABORTED) {
+    if (!g_upCur || g_upStatus) return;
+    rawUploadFinish(raw.status == RAW_END);
+  }
+}
+
+void handleRawUploadDone() {
+  String back = server.hasArg("back") ? server.arg("back") : "/";
+  if (g_upStatus == 415) { server.send(415, "text/html", WebPages::uploadRejectedPage(back)); return; }
+  if (g_upStatus)        { server.send(g_upStatus, "text/html", WebPages::uploadFailurePage(back)); return; }
+  server.send(200, "text/html", WebPages::uploadSuccessPage(back, g_uploadFilename, g_uploadBytes, g_uploadMs));
 }
 
 void handleSdReinit() {
@@ -664,6 +1071,25 @@ void handleSdReinit() {
   else server.send(500,"text/plain", String("reopen fail: ")+why);
 }
 
+namespace {
+// Remount with the current width/clock settings and reopen the playing file
+bool remountSdAndReopen(bool& reopened) {
+  reopened = false;
+  if (!cardPresent()) { g_sdReady = false; g_sdBusWidth = 0; g_sdUnkeyedCal = false; return false; }
+  if (g_sdMutex && SD_LOCK(pdMS_TO_TICKS(2000))) { SD_MMC.end(); g_sdBusWidth = 0; g_sdReady = false; SD_UNLOCK(); }
+  delay(20);
+  g_sdFreqKHz = g_sdBaseFreqKHz;
+  if (!mountSdmmc()) return false;
+  g_sdFailStreak = 0;
+  if (g_currentPath.length()) {
+    String why;
+    reopened = openFseq(g_currentPath, why);
+    if (!reopened && why.length()) Serial.printf("[SD] reopen after config failed: %s\n", why.c_str());
+  }
+  return true;
+}
+}
+
 void handleSdConfig() {
   if (!server.hasArg("mode") || !server.hasArg("freq")) {
     server.send(400, "application/json", "{\"ok\":false,\"error\":\"missing parameters\"}");
@@ -688,23 +1114,8 @@ void handleSdConfig() {
   if (freqVal != g_sdBaseFreqKHz) { g_sdBaseFreqKHz = sanitizeSdFreq(freqVal); g_sdFreqKHz = g_sdBaseFreqKHz; prefs.putUInt("sdfreq", g_sdBaseFreqKHz); changed = true; }
   if (changed) { g_sdFailStreak = 0; persistSettingsToSd(); }
 
-  bool card = cardPresent();
-  bool remounted = false;
   bool reopened = false;
-  if (card) {
-    if (g_sdMutex && SD_LOCK(pdMS_TO_TICKS(2000))) { SD_MMC.end(); g_sdBusWidth = 0; g_sdReady = false; SD_UNLOCK(); }
-    delay(20);
-    g_sdFreqKHz = g_sdBaseFreqKHz;
-    remounted = mountSdmmc();
-    if (remounted) {
-      g_sdFailStreak = 0;
-      if (g_currentPath.length()) {
-        String why;
-        reopened = openFseq(g_currentPath, why);
-        if (!reopened && why.length()) Serial.printf("[SD] reopen after config failed: %s\n", why.c_str());
-      }
-    }
-  } else { g_sdReady = false; g_sdBusWidth = 0; }
+  bool remounted = remountSdAndReopen(reopened);
 
   String json = "{\"ok\":true";
   json += ",\"ready\":" + String(g_sdReady?"true":"false");
@@ -712,12 +1123,63 @@ void handleSdConfig() {
   json += ",\"desiredMode\":" + String((unsigned)g_sdPreferredBusWidth);
   json += ",\"baseFreq\":" + String((unsigned long)g_sdBaseFreqKHz);
   json += ",\"freq\":" + String((unsigned long)g_sdFreqKHz);
+  json += ",\"bus\":" + sdBusJson();
   if (remounted) json += ",\"remounted\":true";
   if (reopened) json += ",\"fileReopened\":true";
   json += "}";
   server.send(200, "application/json", json);
 }
 
+void handleSdCalibrate() {
+  if (g_sdBaseFreqKHz != SD_FREQ_AUTO_KHZ) {
+    server.send(409, "application/json", "{\"ok\":false,\"error\":\"clock is fixed; select Auto first\"}");
+    return;
+  }
+  if (!cardPresent()) { server.send(503, "application/json", "{\"ok\":false,\"error\":\"no card\"}"); return; }
+  if (g_sdCardKey.length()) prefs.remove(g_sdCardKey.c_str());
+  g_sdUnkeyedCal = false;
+  bool reopened = false;
+  bool remounted = remountSdAndReopen(reopened);
+  String json = "{\"ok\":" + String(remounted && g_sdCalibrated ? "true" : "false");
+  json += ",\"currentWidth\":" + String((unsigned)g_sdBusWidth);
+  json += ",\"freq\":" + String((unsigned long)g_sdFreqKHz);
+  json += ",\"bus\":" + sdBusJson();
+  if (reopened) json += ",\"fileReopened\":true";
+  json += "}";
+  server.send(200, "application/json", json);
+}
+
+String sdBusJson() {
+  const SdStats& s = g_sdStats;
+  String json = "{\"card\":\"" + g_sdCardKey + "\"";
+  json += ",\"calibrated\":" + String(g_sdCalibrated ? "true" : "false");
+  json += ",\"readBytes\":" + String((unsigned long long)s.readBytes);
+  json += ",\"readMBps\":" + String(s.readUs ? (double)s.readBytes / (double)s.readUs : 0.0, 2);
+  json += ",\"readErrors\":" + String(s.readErrors);
+  json += ",\"recoveries\":" + String(s.recoveries);
+  json += ",\"demotions\":" + String(s.demotions);
+  json += ",\"mounts\":" + String(s.mounts);
+  json += ",\"mountFails\":" + String(s.mountFails);
+  json += ",\"calibrations\":" + String(s.calibrations);
+  json += ",\"calVerifyFails\":" + String(s.calVerifyFails);
+  json += ",\"calibration\":[";
+  for (uint8_t i = 0; i < g_sdCalCount; ++i) {
+    const SdCalResult& r = g_sdCal[i];
+    if (i) json += ",";
+    json += "{\"width\":" + String((unsigned)r.width);
+    json += ",\"freq\":" + String((unsigned long)r.freqKHz);
+    json += ",\"pass\":" + String(r.pass ? "true" : "false");
+    if (r.pass) {
+      json += ",\"writeMBps\":" + String(r.writeUs ? (double)SD_CAL_BYTES / (double)r.writeUs : 0.0, 2);
+      json += ",\"seqMBps\":" + String(r.seqUs ? (double)SD_CAL_BYTES / (double)r.seqUs : 0.0, 2);
+      json += ",\"randIops\":" + String(r.randUs ? (unsigned long)((uint64_t)SD_CAL_RAND_READS * 1000000ULL / r.randUs) : 0UL);
+    }
+    json += "}";
+  }
+  json += "]}";
+  return json;
+}
+
 namespace {
 bool otaAuthOK() { return true; } // stub for future auth
 
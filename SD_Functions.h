@@ -24,6 +24,22 @@ extern int g_sdFailStreak;
 extern bool g_sdReady;
 extern uint8_t g_sdBusWidth;
 
+// g_sdBaseFreqKHz == SD_FREQ_AUTO_KHZ: benchmark width/clock per card at mount
+constexpr uint32_t SD_FREQ_AUTO_KHZ = 0;
+
+// Card bus counters and live read throughput, reported under /status
+struct SdStats {
+  uint32_t mounts = 0, mountFails = 0;
+  uint32_t readErrors = 0;        // frame loads from the card that failed
+  uint32_t recoveries = 0;        // recoverSd() runs
+  uint32_t demotions = 0;         // calibrated clock stepped down after errors in use
+  uint32_t calibrations = 0;
+  uint32_t calVerifyFails = 0;    // candidate settings that mounted but read back wrong
+  uint64_t readBytes = 0;         // playback reads (frame loads)
+  uint64_t readUs = 0;
+};
+extern SdStats g_sdStats;
+
 bool SD_LOCK(TickType_t timeout = portMAX_DELAY);
 void SD_UNLOCK();
 void ensureBgEffectsDirLocked();
@@ -51,9 +67,13 @@ void handleMkdir();
 void handleRename();
 void handleUploadData();
 void handleUploadDone();
+void handleRawUploadData();   // PUT /upload?path=/show.fseq, body = file, Content-Length required
+void handleRawUploadDone();
 
 void handleSdReinit();
 void handleSdConfig();
+void handleSdCalibrate();   // POST /sd/calibrate: forget this card's setting and benchmark again
+String sdBusJson();
 
 void handleUpdatesPage();
 void handleOtaPage();
@@ -0,0 +1,103 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// Spoke kernels: gather one arm's pixels for one spoke from a decoded frame
+// through its offset table and write lane-ordered SK9822 words (hdr,B,G,R).
+//
+// Everything that is fixed for a configuration is a template parameter, so
+// each instantiation is a straight loop with no per-pixel branches:
+//   CM      source channel order
+//   SPARSE  offset table has holes (-1 = pixel not in the file -> black)
+//   LEVELS  apply the brightness/gamma LUT (false when it is the identity)
+//   REV     arm is centre-fed, pixel 0 lands at the end of the run
+// pickSpokeKernel() returns the instantiation for a configuration; callers
+// keep the pointer until the configuration changes.
+
+enum ColorMap { MAP_RGB, MAP_RBG, MAP_GBR, MAP_GRB, MAP_BRG, MAP_BGR };
+
+typedef void (*SpokeKernel)(const uint8_t* frame, const int32_t* offs, uint16_t n,
+                            const uint8_t* lvl, uint8_t hdr, uint8_t* dst);
+
+template <ColorMap CM>
+static inline void mapChannelsT(const uint8_t* p, uint8_t& r, uint8_t& g, uint8_t& b) {
+  switch (CM) {
+    case MAP_RGB: r=p[0]; g=p[1]; b=p[2]; break;
+    case MAP_RBG: r=p[0]; b=p[1]; g=p[2]; break;
+    case MAP_GBR: g=p[0]; b=p[1]; r=p[2]; break;
+    case MAP_GRB: g=p[0]; r=p[1]; b=p[2]; break;
+    case MAP_BRG: b=p[0]; r=p[1]; g=p[2]; break;
+    case MAP_BGR: b=p[0]; g=p[1]; r=p[2]; break;
+  }
+}
+
+template <ColorMap CM, bool SPARSE, bool LEVELS, bool REV>
+static void spokeKernel(const uint8_t* frame, const int32_t* offs, uint16_t n,
+                        const uint8_t* lvl, uint8_t hdr, uint8_t* dst) {
+  uint8_t* p = REV ? dst + (size_t)(n ? n - 1 : 0) * 4 : dst;
+  for (uint16_t i = 0; i < n; ++i, p = REV ? p - 4 : p + 4) {
+    const int32_t o = offs[i];
+    uint8_t r = 0, g = 0, b = 0;
+    if (!SPARSE || o >= 0) mapChannelsT<CM>(frame + o, r, g, b);
+    p[0] = hdr;
+    p[1] = LEVELS ? lvl[b] : b;
+    p[2] = LEVELS ? lvl[g] : g;
+    p[3] = LEVELS ? lvl[r] : r;
+  }
+}
+
+template <ColorMap CM>
+static SpokeKernel pickSpokeKernelFor(bool sparse, bool levels, bool rev) {
+  static const SpokeKernel k[8] = {
+    spokeKernel<CM, false, false, false>, spokeKernel<CM, false, false, true>,
+    spokeKernel<CM, false, true,  false>, spokeKernel<CM, false, true,  true>,
+    spokeKernel<CM, true,  false, false>, spokeKernel<CM, true,  false, true>,
+    spokeKernel<CM, true,  true,  false>, spokeKernel<CM, true,  true,  true>,
+  };
+  return k[(sparse ? 4 : 0) | (levels ? 2 : 0) | (rev ? 1 : 0)];
+}
+
+static inline SpokeKernel pickSpokeKernel(ColorMap cm, bool sparse, bool levels, bool rev) {
+  switch (cm) {
+    case MAP_RBG: return pickSpokeKernelFor<MAP_RBG>(sparse, levels, rev);
+    case MAP_GBR: return pickSpokeKernelFor<MAP_GBR>(sparse, levels, rev);
+    case MAP_GRB: return pickSpokeKernelFor<MAP_GRB>(sparse, levels, rev);
+    case MAP_BRG: return pickSpokeKernelFor<MAP_BRG>(sparse, levels, rev);
+    case MAP_BGR: return pickSpokeKernelFor<MAP_BGR>(sparse, levels, rev);
+    case MAP_RGB:
+    default:      return pickSpokeKernelFor<MAP_RGB>(sparse, levels, rev);
+  }
+}
+
+// True when lvl/hdr leave colour untouched (full brightness, linear gamma)
+static inline bool levelsAreIdentity(const uint8_t* lvl, uint8_t hdr) {
+  if (hdr != 0xFF) return false;
+  for (int v = 0; v < 256; ++v) if (lvl[v] != v) return false;
+  return true;
+}
+
+// Reference: the same result with every decision taken per pixel (the shape
+// of the old paint loop).  Used by the on-device kernel benchmark/self-check.
+static inline void spokeKernelGeneric(ColorMap cm, bool rev, const uint8_t* frame, const int32_t* offs,
+                                      uint16_t n, const uint8_t* lvl, uint8_t hdr, uint8_t* dst) {
+  for (uint16_t i = 0; i < n; ++i) {
+    uint8_t r = 0, g = 0, b = 0;
+    const int32_t o = offs[i];
+    if (o >= 0) {
+      const uint8_t* c = frame + o;
+      switch (cm) {
+        case MAP_RGB: r=c[0]; g=c[1]; b=c[2]; break;
+        case MAP_RBG: r=c[0]; b=c[1]; g=c[2]; break;
+        case MAP_GBR: g=c[0]; b=c[1]; r=c[2]; break;
+        case MAP_GRB: g=c[0]; r=c[1]; b=c[2]; break;
+        case MAP_BRG: b=c[0]; r=c[1]; g=c[2]; break;
+        case MAP_BGR: b=c[0]; g=c[1]; r=c[2]; break;
+      }
+    }
+    uint8_t* p = dst + (size_t)(rev ? (n - 1 - i) : i) * 4;
+    p[0] = hdr;
+    p[1] = lvl[b];
+    p[2] = lvl[g];
+    p[3] = lvl[r];
+  }
+}
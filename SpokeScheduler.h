@@ -0,0 +1,106 @@
+#pragma once
+#include <stdint.h>
+
+// Spoke scheduler core: when the next spoke starts and when each lit arm goes
+// dark.  Pure bookkeeping on a wrapping 32-bit microsecond timeline.  The
+// caller passes "now" from whatever clock it has (micros() + a gptimer alarm
+// on the device, a simulated clock on a host) and acts on what comes back.
+// No Arduino or FreeRTOS, so it builds and runs on a host.
+
+static inline bool usReached(uint32_t now, uint32_t target) { return (int32_t)(now - target) >= 0; }
+
+class SpokeScheduler {
+public:
+  static const uint8_t MAX_ARMS = 8;
+
+  void reset() {
+    _spokes = 0; _spokeUs = 0; _nextUs = 0; _step = 0;
+    _lit = 0; _prepared = -1;
+    for (uint8_t a = 0; a < MAX_ARMS; ++a) _blankAt[a] = 0;
+  }
+
+  // Hall sync: step 0 is drawn at syncUs, step 1 starts spokeUs later
+  void sync(uint32_t syncUs, uint32_t spokeUs, uint16_t spokes) {
+    _spokes  = spokes;
+    _spokeUs = spokeUs ? spokeUs : 1;
+    _step    = 0;
+    _nextUs  = syncUs + _spokeUs;
+    _prepared = -1;
+  }
+
+  bool     running()     const { return _spokes && _spokeUs; }
+  uint32_t spokeUs()     const { return _spokeUs; }
+  uint16_t step()        const { return _step; }
+  uint32_t nextSpokeUs() const { return _nextUs; }
+  // Step of the spoke that starts at nextSpokeUs()
+  uint16_t upcomingStep() const { return _spokes ? (uint16_t)((_step + 1) % _spokes) : 0; }
+
+  // True when a spoke start is due at nowUs.  Moves to the latest due spoke;
+  // spokes that passed entirely are counted in skipped(), not replayed.
+  bool spokeDue(uint32_t nowUs, uint16_t& step, uint32_t& startUs) {
+    if (!running() || !usReached(nowUs, _nextUs)) return false;
+    uint32_t late = nowUs - _nextUs;
+    uint32_t n = late / _spokeUs;          // whole spokes missed
+    _skipped += n;
+    startUs  = _nextUs + n * _spokeUs;
+    _step    = (uint16_t)((_step + 1 + n) % _spokes);
+    _nextUs  = startUs + _spokeUs;
+    step = _step;
+    return true;
+  }
+
+  // The caller drew `step` into its back buffers ahead of its start time
+  void markPrepared(uint16_t step) { _prepared = step; }
+  bool isPrepared(uint16_t step) const { return _prepared == (int32_t)step; }
+  void clearPrepared() { _prepared = -1; }
+
+  // Arm went out at atUs and stays lit for blankUs
+  void lit(uint8_t arm, uint32_t atUs, uint32_t blankUs) {
+    if (arm >= MAX_ARMS) return;
+    _lit |= (uint8_t)(1u << arm);
+    _blankAt[arm] = atUs + blankUs;
+  }
+  void dark(uint8_t arm) { if (arm < MAX_ARMS) _lit &= (uint8_t)~(1u << arm); }
+  bool isLit(uint8_t arm) const { return arm < MAX_ARMS && (_lit >> arm) & 1; }
+
+  // Lit arms whose blank time has come
+  uint8_t blanksDue(uint32_t nowUs) const {
+    uint8_t m = 0;
+    for (uint8_t a = 0; a < MAX_ARMS; ++a)
+      if (((_lit >> a) & 1) && usReached(nowUs, _blankAt[a])) m |= (uint8_t)(1u << a);
+    return m;
+  }
+
+  // Earliest pending spoke start or blank; false if nothing is scheduled
+  bool nextEvent(uint32_t nowUs, uint32_t& atUs, bool& isSpoke) const {
+    bool have = false;
+    int32_t best = 0;
+    if (running()) { best = (int32_t)(_nextUs - nowUs); atUs = _nextUs; isSpoke = true; have = true; }
+    for (uint8_t a = 0; a < MAX_ARMS; ++a) {
+      if (!((_lit >> a) & 1)) continue;
+      const int32_t d = (int32_t)(_blankAt[a] - nowUs);
+      if (!have || d < best) { best = d; atUs = _blankAt[a]; isSpoke = false; have = true; }
+    }
+    return have;
+  }
+
+  // Microseconds until the next event (0 if overdue, UINT32_MAX if none)
+  uint32_t usUntilNext(uint32_t nowUs) const {
+    uint32_t at; bool spoke;
+    if (!nextEvent(nowUs, at, spoke)) return UINT32_MAX;
+    const int32_t d = (int32_t)(at - nowUs);
+    return d <= 0 ? 0 : (uint32_t)d;
+  }
+
+  uint32_t skipped() const { return _skipped; }
+
+private:
+  uint16_t _spokes   = 0;
+  uint32_t _spokeUs  = 0;
+  uint32_t _nextUs   = 0;
+  uint16_t _step     = 0;
+  int32_t  _prepared = -1;
+  uint8_t  _lit      = 0;
+  uint32_t _blankAt[MAX_ARMS] = { 0 };
+  uint32_t _skipped  = 0;
+};
@@ -89,13 +89,21 @@ String filesPageHeader(const String &pathEscaped,
           "<button onclick='location.reload()'>Refresh</button>"
           "</div>";
 
-  html += "<form class='row' method='POST' action='/upload' enctype='multipart/form-data' style='align-items:center;margin-top:.75rem'>"
+  // Sent as a raw PUT (preallocated, large buffered writes) where the browser
+  // can; the multipart POST stays as the fallback
+  html += "<form class='row' method='POST' action='/upload' enctype='multipart/form-data' style='align-items:center;margin-top:.75rem'"
+          " onsubmit='return putUpload(this)'>"
           "<input type='hidden' name='dir' value='" + currentPathAttrEscaped + "'>"
           "<input type='hidden' name='back' value='" + backAttrEscaped + "'>"
           "<label class='muted' style='min-width:fit-content'>Upload .fseq:</label>"
           "<input type='file' name='file' accept='.fseq' required>"
           "<button type='submit'>Upload</button>"
-          "</form>";
+          "</form>"
+          "<script>function putUpload(f){const file=f.file.files[0];if(!file||!window.fetch)return true;"
+          "const d=f.dir.value.endsWith('/')?f.dir.value:f.dir.value+'/';"
+          "fetch('/upload?path='+encodeURIComponent(d+file.name)+'&back='+encodeURIComponent(f.back.value),{method:'PUT',body:file})"
+          ".then(r=>r.text()).then(t=>{document.open();document.write(t);document.close();})"
+          ".catch(()=>f.submit());return false;}</script>";
 
   html += "<table><thead><tr><th>Name</th><th>Size</th><th>Actions</th></tr></thead><tbody>";
   return html;
@@ -181,11 +189,14 @@ String rootPage(const String &statusClass,
   const char *sd4Sel    = (sdPreferredMode == 4) ? "selected" : "";
   const char *sd1Sel    = (sdPreferredMode == 1) ? "selected" : "";
 
-  const char *freq8Sel = (sdBaseFreqKHz == 8000) ? "selected" : "";
-  const char *freq4Sel = (sdBaseFreqKHz == 4000) ? "selected" : "";
-  const char *freq2Sel = (sdBaseFreqKHz == 2000) ? "selected" : "";
-  const char *freq1Sel = (sdBaseFreqKHz == 1000) ? "selected" : "";
-  const char *freq0Sel = (sdBaseFreqKHz ==  400) ? "selected" : "";
+  const char *freqASel  = (sdBaseFreqKHz ==     0) ? "selected" : "";
+  const char *freq40Sel = (sdBaseFreqKHz == 40000) ? "selected" : "";
+  const char *freq20Sel = (sdBaseFreqKHz == 20000) ? "selected" : "";
+  const char *freq8Sel  = (sdBaseFreqKHz ==  8000) ? "selected" : "";
+  const char *freq4Sel  = (sdBaseFreqKHz ==  4000) ? "selected" : "";
+  const char *freq2Sel  = (sdBaseFreqKHz ==  2000) ? "selected" : "";
+  const char *freq1Sel  = (sdBaseFreqKHz ==  1000) ? "selected" : "";
+  const char *freq0Sel  = (sdBaseFreqKHz ==   400) ? "selected" : "";
 
   String sdCurrent = "Current: ";
   if (!sdReady) {
@@ -197,7 +208,8 @@ String rootPage(const String &statusClass,
   }
   sdCurrent += " • Target: ";
   if (sdPreferredMode == 0) sdCurrent += "Auto"; else sdCurrent += String((unsigned)sdPreferredMode) + "-bit";
-  sdCurrent += " @ " + String((unsigned long)sdBaseFreqKHz) + " kHz";
+  if (sdBaseFreqKHz == 0) sdCurrent += " @ Auto";
+  else                    sdCurrent += " @ " + String((unsigned long)sdBaseFreqKHz) + " kHz";
 
   String hallDiagAttrs;
   if (hallDiagEnabled) hallDiagAttrs += " checked";
@@ -304,6 +316,9 @@ String rootPage(const String &statusClass,
           "<option value='1' " + String(sd1Sel) + ">Force 1-bit</option>"
           "</select></div>"
           "<div style='min-width:140px'><label>Clock Frequency</label><select id='sdfreq'>"
+          "<option value='0' " + String(freqASel) + ">Auto (benchmark per card)</option>"
+          "<option value='40000' " + String(freq40Sel) + ">40 MHz (high speed)</option>"
+          "<option value='20000' " + String(freq20Sel) + ">20 MHz</option>"
           "<option value='8000' " + String(freq8Sel) + ">8 MHz</option>"
           "<option value='4000' " + String(freq4Sel) + ">4 MHz</option>"
           "<option value='2000' " + String(freq2Sel) + ">2 MHz</option>"
@@ -312,6 +327,7 @@ String rootPage(const String &statusClass,
           "</select></div>"
           "<div style='align-self:end'><button id='applysd'>Apply SD Settings</button></div>"
           "<div style='align-self=end'><button id='sdrefresh'>Refresh SD Status</button></div>"
+          "<div style='align-self:end'><button id='sdcal'>Re-benchmark Card</button></div>"
           "</div>"
           "<div id='sdinfo' class='muted' style='margin-top:.4rem'>" + sdCurrent + "</div>"
           "<div class='sep'></div>";
@@ -476,8 +492,13 @@ function formatSd(j){
   if(!j||!j.sd) return 'Unavailable';
   const d=j.sd;
   let cur=d.ready?(d.currentWidth?d.currentWidth+'-bit':'Unknown width')+' @ '+d.freq+' kHz':'Card not mounted';
-  const tgt=(d.desiredMode?d.desiredMode+'-bit':'Auto')+' @ '+d.baseFreq+' kHz';
-  return 'Current: '+cur+' • Target: '+tgt;
+  const tgt=(d.desiredMode?d.desiredMode+'-bit':'Auto')+' @ '+(d.baseFreq?d.baseFreq+' kHz':'Auto');
+  let bus='';
+  if(d.bus){
+    bus=' • Read '+d.bus.readMBps+' MB/s, '+d.bus.readErrors+' errors, '+d.bus.recoveries+' recoveries';
+    if(d.bus.calibrated) bus+=' (benchmarked)';
+  }
+  return 'Current: '+cur+' • Target: '+tgt+bus;
 }
 function updateSd(){
   fetch('/status').then(r=>r.json()).then(j=>{if(sdinfo) sdinfo.textContent=formatSd(j);})
@@ -487,6 +508,17 @@ updateSd();
 const sdrefresh=document.getElementById('sdrefresh');
 if(sdrefresh){sdrefresh.onclick=()=>updateSd();}
 
+const sdcal=document.getElementById('sdcal');
+if(sdcal){
+  sdcal.onclick=()=>{
+    if(sdinfo) sdinfo.textContent='Benchmarking card...';
+    fetch('/sd/calibrate',{method:'POST'}).then(r=>r.json()).then(j=>{
+      if(j.error){if(sdinfo) sdinfo.textContent='Error: '+j.error;}
+      else updateSd();
+    }).catch(()=>{if(sdinfo) sdinfo.textContent='Benchmark failed';});
+  };
+}
+
 const applysd=document.getElementById('applysd');
 if(applysd){
   applysd.onclick=()=>{
@@ -629,9 +661,12 @@ String uploadFailurePage(const String &backUrl) {
 
 String uploadSuccessPage(const String &backUrl,
                          const String &filename,
-                         size_t bytesWritten) {
+                         size_t bytesWritten,
+                         uint32_t elapsedMs) {
   String nameEsc = htmlEscape(filename);
-  String body = "<div class='card'><p>Uploaded <b>" + nameEsc + "</b> (" + String((unsigned long)bytesWritten) + " bytes).</p><p>Refreshing…</p></div>";
+  String rate = elapsedMs ? String((double)bytesWritten / 1000.0 / (double)elapsedMs, 2) + " MB/s" : String("-");
+  String body = "<div class='card'><p>Uploaded <b>" + nameEsc + "</b> (" + String((unsigned long)bytesWritten) + " bytes in " +
+                String((unsigned long)elapsedMs) + " ms, " + rate + ").</p><p>Refreshing…</p></div>";
   return uploadRefreshPage(backUrl, 1, body);
 }
 
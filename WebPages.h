@@ -70,6 +70,7 @@ String uploadRejectedPage(const String &backUrl);
 String uploadFailurePage(const String &backUrl);
 String uploadSuccessPage(const String &backUrl,
                          const String &filename,
-                         size_t bytesWritten);
+                         size_t bytesWritten,
+                         uint32_t elapsedMs);
 
 }  // namespace WebPages
@@ -0,0 +1,137 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "FseqFormat.h"
+#include "mock/MockFile.h"
+#include "src/zstd/zstd.h"
+#if defined(FSEQ_HOST_ZLIB)
+#include <zlib.h>
+#endif
+
+// Host FSEQ player core: the open/load path of the sketch (header, block
+// table, sparse ranges, block index, per-block decode) on FseqFormat.h and a
+// MockFile, without the device's caches, ring or locking.  One decoded block
+// is kept, so sequential play inflates each block once.
+
+class FseqReader {
+public:
+  ~FseqReader() { if (_dctx) ZSTD_freeDCtx(_dctx); }
+
+  // nullptr on success, else the reason (the sketch's openFseq() strings)
+  const char* open(const File& file) {
+    close();
+    _f = file;
+    if (!_f) return "open fail";
+    uint8_t hdr[FSEQ_HEADER_BYTES];
+    if (!_f.seek(0) || _f.read(hdr, sizeof(hdr)) != sizeof(hdr)) return "short";
+    if (const char* err = fseqDecodeHeader(hdr, _h)) return err;
+    if (_h.channelCount == 0) return "zero chans";
+
+    _cblocks.resize(_h.compBlockCnt);
+    for (auto& b : _cblocks) {
+      uint8_t e[FSEQ_COMP_ENTRY_BYTES];
+      if (_f.read(e, sizeof(e)) != sizeof(e)) return "ctab";
+      b = fseqDecodeCompBlock(e);
+    }
+    _compCount = fseqTrimBlocks(_cblocks.data(), _h.compBlockCnt);
+    _compOffs.resize(_compCount + 1);
+    fseqBlockOffsets(_cblocks.data(), _compCount, _h.chanDataOffset, _compOffs.data());
+
+    _ranges.resize(_h.sparseCnt);
+    uint32_t accum = 0;
+    for (auto& r : _ranges) {
+      uint8_t e[FSEQ_RANGE_BYTES];
+      if (_f.read(e, sizeof(e)) != sizeof(e)) return "ranges";
+      r = fseqDecodeRange(e, accum);
+      accum += r.count;
+    }
+    _sorted.resize(_h.sparseCnt);
+    _mode = fseqIndexSparse(_ranges.data(), _h.sparseCnt, _sorted.data());
+
+    if (_h.compType == 1 || _h.compType == 2) {
+#if !defined(FSEQ_HOST_ZLIB)
+      if (_h.compType == 2) return "zlib not available";
+#endif
+      _first.resize(_compCount + 1);
+      if (const char* err = fseqBuildBlockIndex(_cblocks.data(), _compCount, _h.channelCount, _h.frameCount,
+                                                _first.data(), _blockFrames)) return err;
+      _block.resize((size_t)_blockFrames * _h.channelCount);
+    } else if (_h.compType != 0) {
+      return "unknown compression";
+    }
+    return nullptr;
+  }
+
+  // Frame idx (channelCount bytes) into dst
+  bool loadFrame(uint32_t idx, uint8_t* dst) {
+    const uint32_t chans = _h.channelCount;
+    if (!_f || idx >= _h.frameCount) return false;
+    if (_h.compType == 0) {
+      const uint64_t off = (uint64_t)_h.chanDataOffset + (uint64_t)idx * chans;
+      return _f.seek(off) && _f.read(dst, chans) == chans;
+    }
+    const uint32_t b = fseqFrameBlock(_first.data(), _compCount, _blockFrames == 1, idx);
+    if (b != _blockLoaded) {
+      const uint32_t frames = _first[b + 1] - _first[b];
+      const uint32_t clen = _cblocks[b].cSize;
+      if (_ctmp.size() < clen) _ctmp.resize(clen);
+      if (!_f.seek(_compOffs[b]) || _f.read(_ctmp.data(), clen) != clen) return false;
+      ++_blockReads;
+      if (!decode(_ctmp.data(), clen, _block.data(), (size_t)frames * chans)) { _blockLoaded = UINT32_MAX; return false; }
+      _blockLoaded = b;
+    }
+    memcpy(dst, _block.data() + (size_t)(idx - _first[b]) * chans, chans);
+    return true;
+  }
+
+  int64_t translate(uint32_t absCh) const {
+    return fseqSparseTranslate(_mode, _ranges.data(), _sorted.data(), _h.sparseCnt, _h.channelCount, absCh);
+  }
+
+  const FseqHeader& header()      const { return _h; }
+  uint32_t          blocks()      const { return _compCount; }
+  uint32_t          blockFrames() const { return _blockFrames; }
+  uint32_t          blockReads()  const { return _blockReads; }
+  uint8_t           sparseMode()  const { return _mode; }
+  File&             file()              { return _f; }
+
+  void close() {
+    _f.close();
+    _h = FseqHeader();
+    _cblocks.clear(); _compOffs.clear(); _first.clear(); _ranges.clear(); _sorted.clear();
+    _compCount = 0; _blockFrames = 0; _mode = XLATE_DENSE;
+    _blockLoaded = UINT32_MAX; _blockReads = 0;
+  }
+
+private:
+  bool decode(const uint8_t* src, size_t srcLen, uint8_t* dst, size_t dstLen) {
+    if (_h.compType == 1) {
+      if (!_dctx) _dctx = ZSTD_createDCtx();
+      if (!_dctx) return false;
+      const size_t got = ZSTD_decompressDCtx(_dctx, dst, dstLen, src, srcLen);
+      return !ZSTD_isError(got) && got == dstLen;
+    }
+#if defined(FSEQ_HOST_ZLIB)
+    uLongf out = (uLongf)dstLen;
+    return uncompress(dst, &out, src, (uLong)srcLen) == Z_OK && out == dstLen;
+#else
+    return false;
+#endif
+  }
+
+  File                     _f;
+  FseqHeader               _h;
+  std::vector<CompBlock>   _cblocks;
+  uint32_t                 _compCount = 0;
+  std::vector<uint64_t>    _compOffs;
+  std::vector<uint32_t>    _first;
+  uint32_t                 _blockFrames = 0;
+  std::vector<SparseRange> _ranges, _sorted;
+  uint8_t                  _mode = XLATE_DENSE;
+  std::vector<uint8_t>     _ctmp, _block;
+  uint32_t                 _blockLoaded = UINT32_MAX;
+  uint32_t                 _blockReads = 0;
+  ZSTD_DCtx*               _dctx = nullptr;
+};
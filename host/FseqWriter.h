@@ -0,0 +1,111 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "FseqFormat.h"
+#if defined(FSEQ_HOST_ZLIB)
+#include <zlib.h>
+#endif
+
+// Builds FSEQ v2 images for host tests and benches.  zstd blocks are written
+// as raw (stored) zstd frames: the device only carries a decompressor, and a
+// stored frame still goes through the whole frame/block decode path.  zlib
+// blocks use the system zlib when the host build found it.
+
+struct FseqBuildCfg {
+  uint32_t chans          = 0;     // channels per frame as stored (sum of ranges when sparse)
+  uint32_t frames         = 0;
+  uint8_t  stepTimeMs     = 25;
+  uint8_t  compType       = 0;     // 0=none, 1=zstd, 2=zlib
+  uint32_t framesPerBlock = 1;
+  bool     sizeTable      = false; // legacy table: uncompressed block size, not first frame
+  uint8_t  padEntries     = 0;     // empty table entries after the last block (xLights)
+  uint64_t uniqueId       = 0x1122334455667788ull;
+  std::vector<SparseRange> ranges; // start, count (accum ignored)
+};
+
+static inline void fseqPut16(std::vector<uint8_t>& o, uint16_t v) { o.push_back((uint8_t)v); o.push_back((uint8_t)(v >> 8)); }
+static inline void fseqPut24(std::vector<uint8_t>& o, uint32_t v) { fseqPut16(o, (uint16_t)v); o.push_back((uint8_t)(v >> 16)); }
+static inline void fseqPut32(std::vector<uint8_t>& o, uint32_t v) { fseqPut16(o, (uint16_t)v); fseqPut16(o, (uint16_t)(v >> 16)); }
+
+// One zstd frame of stored blocks holding src[0..n)
+static inline std::vector<uint8_t> zstdStoredFrame(const uint8_t* src, size_t n) {
+  std::vector<uint8_t> o;
+  fseqPut32(o, 0xFD2FB528u);            // magic
+  o.push_back(0xA0);                    // 4-byte content size, single segment, no checksum
+  fseqPut32(o, (uint32_t)n);
+  const size_t MAX_BLOCK = 128 * 1024;
+  size_t done = 0;
+  do {
+    const size_t len = (n - done < MAX_BLOCK) ? n - done : MAX_BLOCK;
+    const bool last = (done + len == n);
+    fseqPut24(o, (uint32_t)(len << 3) | (last ? 1u : 0u));   // type 0 = raw
+    o.insert(o.end(), src + done, src + done + len);
+    done += len;
+  } while (done < n);
+  return o;
+}
+
+// frameData: frames * chans bytes; an empty vector on a bad configuration
+static inline std::vector<uint8_t> fseqBuild(const FseqBuildCfg& c, const std::vector<uint8_t>& frameData) {
+  std::vector<uint8_t> out;
+  if (!c.chans || (size_t)c.chans * c.frames != frameData.size()) return out;
+
+  std::vector<std::vector<uint8_t>> blocks;
+  std::vector<uint32_t> first;
+  if (c.compType) {
+    const uint32_t per = c.framesPerBlock ? c.framesPerBlock : 1;
+    for (uint32_t f = 0; f < c.frames; f += per) {
+      const uint32_t k = (c.frames - f < per) ? c.frames - f : per;
+      const uint8_t* src = frameData.data() + (size_t)f * c.chans;
+      const size_t n = (size_t)k * c.chans;
+      first.push_back(f);
+      if (c.compType == 1) {
+        blocks.push_back(zstdStoredFrame(src, n));
+      } else {
+#if defined(FSEQ_HOST_ZLIB)
+        uLongf cap = compressBound((uLong)n);
+        std::vector<uint8_t> z(cap);
+        if (compress2(z.data(), &cap, src, (uLong)n, 6) != Z_OK) return out;
+        z.resize(cap);
+        blocks.push_back(z);
+#else
+        return out;
+#endif
+      }
+    }
+  }
+  const uint32_t entries = (uint32_t)blocks.size() + (c.compType ? c.padEntries : 0);
+  if (entries > 0xFFF || c.ranges.size() > 255) return out;
+
+  const uint32_t tableBytes = entries * FSEQ_COMP_ENTRY_BYTES + (uint32_t)c.ranges.size() * FSEQ_RANGE_BYTES;
+  const uint16_t cdo = (uint16_t)((FSEQ_HEADER_BYTES + tableBytes + 3) & ~3u);
+  out.insert(out.end(), { 'P', 'S', 'E', 'Q' });
+  fseqPut16(out, cdo);
+  out.push_back(0); out.push_back(2);                 // v2.0
+  fseqPut16(out, cdo);                                // no variable headers
+  fseqPut32(out, c.chans);
+  fseqPut32(out, c.frames);
+  out.push_back(c.stepTimeMs);
+  out.push_back(0);                                   // flags
+  out.push_back((uint8_t)((c.compType & 0x0F) | ((entries >> 4) & 0xF0)));
+  out.push_back((uint8_t)entries);
+  out.push_back((uint8_t)c.ranges.size());
+  out.push_back(0);
+  fseqPut32(out, (uint32_t)c.uniqueId);
+  fseqPut32(out, (uint32_t)(c.uniqueId >> 32));
+
+  for (size_t i = 0; i < blocks.size(); ++i) {
+    const uint32_t next = (i + 1 < first.size()) ? first[i + 1] : c.frames;
+    fseqPut32(out, c.sizeTable ? (next - first[i]) * c.chans : first[i]);
+    fseqPut32(out, (uint32_t)blocks[i].size());
+  }
+  for (uint32_t i = blocks.size(); i < entries; ++i) { fseqPut32(out, 0); fseqPut32(out, 0); }
+  for (const SparseRange& r : c.ranges) { fseqPut24(out, r.start); fseqPut24(out, r.count); }
+  out.resize(cdo, 0);
+
+  if (!c.compType) out.insert(out.end(), frameData.begin(), frameData.end());
+  for (const auto& b : blocks) out.insert(out.end(), b.begin(), b.end());
+  return out;
+}
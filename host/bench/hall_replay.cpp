@@ -0,0 +1,94 @@
+// Off-device tuning of the angle estimator: replays a Hall sync trace and
+// prints the angular error per spoke for the tracker and the old EMA, the
+// same numbers as /hall/replay.
+//
+//   hall_replay <trace.bin | trace.txt> [--spokes 40] [--warmup 4] [--alpha a] [--beta b] [--gamma g] [--reject r]
+//   hall_replay --sim <rpm> [--rpm-end r --ramp-ms ms] [--jitter us] [--drop n] [--syncs n] [--save out.bin]
+//
+// trace.bin is what /hall/trace?action=save writes (little-endian uint32 sync
+// times); any other file is read as text, one time per line.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "AngleEstimator.h"
+#include "TraceGen.h"
+
+static bool endsWith(const char* s, const char* suf) {
+  const size_t a = strlen(s), b = strlen(suf);
+  return a >= b && strcmp(s + a - b, suf) == 0;
+}
+
+static std::vector<uint32_t> readTrace(const char* path) {
+  std::vector<uint32_t> ts;
+  FILE* f = fopen(path, endsWith(path, ".bin") ? "rb" : "r");
+  if (!f) return ts;
+  if (endsWith(path, ".bin")) {
+    uint8_t b[4];
+    while (fread(b, 1, 4, f) == 4) ts.push_back((uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24));
+  } else {
+    unsigned long v;
+    while (fscanf(f, "%lu", &v) == 1) ts.push_back((uint32_t)v);
+  }
+  fclose(f);
+  return ts;
+}
+
+static bool writeTrace(const char* path, const std::vector<uint32_t>& ts) {
+  FILE* f = fopen(path, "wb");
+  if (!f) return false;
+  for (uint32_t t : ts) { const uint8_t b[4] = { (uint8_t)t, (uint8_t)(t >> 8), (uint8_t)(t >> 16), (uint8_t)(t >> 24) }; fwrite(b, 1, 4, f); }
+  return fclose(f) == 0;
+}
+
+static void printStats(const char* name, const ReplayStats& r) {
+  printf("  %-10s revs=%-6lu mean=%.3f rms=%.3f max=%.3f deg  rejected=%lu\n", name, (unsigned long)r.revs,
+         r.meanAbsDeg, r.rmsDeg, r.maxAbsDeg, (unsigned long)r.rejected);
+}
+
+int main(int argc, char** argv) {
+  const char* path = nullptr;
+  const char* save = nullptr;
+  uint16_t spokes = 40;
+  uint32_t syncs = 600;
+  uint8_t  warmup = 4;             // revolutions not scored while the trackers acquire
+  bool sim = false;
+  RotationSimCfg sc;
+  AngleEstimatorCfg cfg;
+  for (int i = 1; i < argc; ++i) {
+    const char* k = argv[i];
+    const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if (k[0] != '-') { path = k; continue; }
+    if (!v) { fprintf(stderr, "%s needs a value\n", k); return 2; }
+    ++i;
+    if      (!strcmp(k, "--spokes"))  spokes = (uint16_t)atoi(v);
+    else if (!strcmp(k, "--warmup"))  warmup = (uint8_t)atoi(v);
+    else if (!strcmp(k, "--alpha"))   cfg.alpha = (float)atof(v);
+    else if (!strcmp(k, "--beta"))    cfg.beta = (float)atof(v);
+    else if (!strcmp(k, "--gamma"))   cfg.gamma = (float)atof(v);
+    else if (!strcmp(k, "--reject"))  cfg.rejectFrac = (float)atof(v);
+    else if (!strcmp(k, "--sim"))     { sim = true; sc.rpm = (float)atof(v); }
+    else if (!strcmp(k, "--rpm-end")) sc.rpmEnd = (float)atof(v);
+    else if (!strcmp(k, "--ramp-ms")) sc.rampMs = (uint32_t)atoi(v);
+    else if (!strcmp(k, "--jitter"))  sc.jitterUs = (uint32_t)atoi(v);
+    else if (!strcmp(k, "--drop"))    sc.dropEvery = (uint8_t)atoi(v);
+    else if (!strcmp(k, "--syncs"))   syncs = (uint32_t)atoi(v);
+    else if (!strcmp(k, "--save"))    save = v;
+    else { fprintf(stderr, "unknown option %s\n", k); return 2; }
+  }
+  if (!sim && !path) { fprintf(stderr, "usage: hall_replay <trace> | --sim <rpm> [options]\n"); return 2; }
+  if (!spokes) { fprintf(stderr, "--spokes must be > 0\n"); return 2; }
+
+  const std::vector<uint32_t> ts = sim ? simulatedTrace(sc, syncs) : readTrace(path);
+  if (ts.size() < 2) { fprintf(stderr, "%s: need 2+ sync times\n", sim ? "simulation" : path); return 1; }
+  if (save && !writeTrace(save, ts)) { fprintf(stderr, "cannot write %s\n", save); return 1; }
+
+  ReplayStats est, legacy;
+  replayHallTrace(ts.data(), ts.size(), spokes, cfg, est, legacy, warmup);
+  printf("hall_replay: %s, %lu syncs, %u spokes, alpha=%.3f beta=%.3f gamma=%.3f reject=%.2f\n",
+         sim ? "simulated" : path, (unsigned long)ts.size(), (unsigned)spokes, cfg.alpha, cfg.beta, cfg.gamma,
+         cfg.rejectFrac);
+  printStats("estimator", est);
+  printStats("legacy", legacy);
+  return 0;
+}
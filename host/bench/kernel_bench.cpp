@@ -0,0 +1,60 @@
+// Spoke kernel benchmark: the selected template kernel against the generic
+// per-pixel path (colour order, holes, levels and direction decided per
+// pixel, the shape of the old paint loop) for every configuration.
+//
+//   kernel_bench [pixels=144] [iters=20000]
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "KernelFixture.h"
+
+static inline uint64_t nowNs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char** argv) {
+  const uint16_t n = (uint16_t)(argc > 1 ? atoi(argv[1]) : 144);
+  const uint32_t iters = (uint32_t)(argc > 2 ? atoi(argv[2]) : 20000);
+  if (!n || n > 1024 || !iters) { fprintf(stderr, "usage: kernel_bench [pixels 1..1024] [iters]\n"); return 2; }
+
+  // The map reaches the generic path at run time, as g_colorMap does on the device
+  volatile int mapSel = 0;
+  std::vector<uint8_t> ref((size_t)n * 4), out((size_t)n * 4);
+  uint32_t sink = 0, mismatches = 0;
+  double sumGen = 0, sumKer = 0;
+
+  printf("kernel_bench: %u pixels, %lu iterations per case (ns per spoke)\n", (unsigned)n, (unsigned long)iters);
+  printf("  %-4s %-6s %-6s %-4s %10s %10s %8s\n", "map", "sparse", "levels", "rev", "generic", "kernel", "speedup");
+  for (int m = 0; m < 6; ++m) {
+    mapSel = m;
+    const ColorMap cm = KERNEL_MAPS[mapSel];
+    for (int cfg = 0; cfg < 8; ++cfg) {
+      const bool sparse = cfg & 4, levels = cfg & 2, rev = cfg & 1;
+      KernelFixture fx(n, sparse, levels);
+      const SpokeKernel k = pickSpokeKernel(cm, sparse, levels, rev);
+
+      uint64_t t0 = nowNs();
+      for (uint32_t it = 0; it < iters; ++it) {
+        spokeKernelGeneric(KERNEL_MAPS[mapSel], rev, fx.frame.data(), fx.offs.data(), n, fx.lvl, fx.hdr, ref.data());
+        sink += ref[it % ref.size()];
+      }
+      const double gen = (double)(nowNs() - t0) / iters;
+      t0 = nowNs();
+      for (uint32_t it = 0; it < iters; ++it) {
+        k(fx.frame.data(), fx.offs.data(), n, fx.lvl, fx.hdr, out.data());
+        sink += out[it % out.size()];
+      }
+      const double ker = (double)(nowNs() - t0) / iters;
+      if (memcmp(ref.data(), out.data(), ref.size()) != 0) ++mismatches;
+      sumGen += gen; sumKer += ker;
+      printf("  %-4s %-6s %-6s %-4s %10.0f %10.0f %7.2fx\n", KERNEL_MAP_NAMES[m], sparse ? "yes" : "no",
+             levels ? "yes" : "no", rev ? "yes" : "no", gen, ker, ker > 0 ? gen / ker : 0.0);
+    }
+  }
+  printf("  overall: generic %.0f ns, kernel %.0f ns per spoke, %.2fx; %lu mismatches (checksum %lu)\n",
+         sumGen / 48, sumKer / 48, sumKer > 0 ? sumGen / sumKer : 0.0, (unsigned long)mismatches, (unsigned long)sink);
+  return mismatches ? 1 : 0;
+}
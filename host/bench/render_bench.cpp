@@ -0,0 +1,280 @@
+// Host render benchmark: the player's spoke path on mock back ends.
+//
+//   RotationSim -> AngleEstimator -> SpokeScheduler     (when spokes are due)
+//   FrameClock + FseqReader on a MockFile               (which frame, and its load)
+//   PixelMap rows -> spoke kernels -> LaneOutput        (paint, commit)
+//   CountingSink                                        (wire time per lane)
+//
+// Time is the mock micros() clock.  Host CPU work (kernel paint, decode) is
+// measured with a steady clock and charged to it scaled by --cpu-scale (how
+// much slower the target core is than this host), SD reads by the MockFile
+// cost model and lane transfers by the sink's bus rate.  As on the device the
+// frame producer runs beside the render loop (its own timeline, a ring of
+// RING frames), so a slow load shows up as a ring underrun, not a late spoke.
+//
+//   render_bench [--rpm 600] [--spokes 40] [--arms 4] [--pixels 144] [--revs 200]
+//                [--comp none|zstd|zlib] [--fpb 10] [--fseq file] [--trace file]
+//                [--sd-kbps 8000] [--sd-req-us 400] [--spi-hz 10000000] [--cpu-scale 1]
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "FrameClock.h"
+#include "FseqReader.h"
+#include "FseqWriter.h"
+#include "LaneOutput.h"
+#include "LatencyHist.h"
+#include "PixelMap.h"
+#include "AngleEstimator.h"
+#include "RotationSim.h"
+#include "SpokeKernels.h"
+#include "SpokeScheduler.h"
+#include "mock/CountingSink.h"
+#include "mock/MockClock.h"
+
+struct BenchArgs {
+  float       rpm = 600, cpuScale = 1;
+  uint16_t    spokes = 40, pixels = 144;
+  uint8_t     arms = 4;
+  uint32_t    revs = 200, fpb = 10, frames = 120;
+  uint8_t     comp = 1;
+  const char* fseq = nullptr;
+  const char* trace = nullptr;
+  MockSdCost  sd = { 400, 8000 };
+  uint32_t    spiHz = 10000000;
+};
+
+static const uint8_t RING = 4;   // FRAME_RING_DEPTH on the device
+
+static bool parseArgs(int argc, char** argv, BenchArgs& a) {
+  for (int i = 1; i < argc; ++i) {
+    const char* k = argv[i];
+    const char* v = (i + 1 < argc) ? argv[i + 1] : nullptr;
+    if (!v) { fprintf(stderr, "%s needs a value\n", k); return false; }
+    ++i;
+    if      (!strcmp(k, "--rpm"))       a.rpm = (float)atof(v);
+    else if (!strcmp(k, "--spokes"))    a.spokes = (uint16_t)atoi(v);
+    else if (!strcmp(k, "--arms"))      a.arms = (uint8_t)atoi(v);
+    else if (!strcmp(k, "--pixels"))    a.pixels = (uint16_t)atoi(v);
+    else if (!strcmp(k, "--revs"))      a.revs = (uint32_t)atoi(v);
+    else if (!strcmp(k, "--frames"))    a.frames = (uint32_t)atoi(v);
+    else if (!strcmp(k, "--fpb"))       a.fpb = (uint32_t)atoi(v);
+    else if (!strcmp(k, "--fseq"))      a.fseq = v;
+    else if (!strcmp(k, "--trace"))     a.trace = v;
+    else if (!strcmp(k, "--sd-kbps"))   a.sd.kBps = (uint32_t)atoi(v);
+    else if (!strcmp(k, "--sd-req-us")) a.sd.requestUs = (uint32_t)atoi(v);
+    else if (!strcmp(k, "--spi-hz"))    a.spiHz = (uint32_t)atoi(v);
+    else if (!strcmp(k, "--cpu-scale")) a.cpuScale = (float)atof(v);
+    else if (!strcmp(k, "--comp")) {
+      if      (!strcmp(v, "none")) a.comp = 0;
+      else if (!strcmp(v, "zstd")) a.comp = 1;
+      else if (!strcmp(v, "zlib")) a.comp = 2;
+      else { fprintf(stderr, "--comp none|zstd|zlib\n"); return false; }
+    } else { fprintf(stderr, "unknown option %s\n", k); return false; }
+  }
+  if (!a.spokes || !a.pixels || !a.arms || a.arms > 8) { fprintf(stderr, "bad geometry\n"); return false; }
+  return true;
+}
+
+// One sync time (us) per line
+static std::vector<uint32_t> loadTrace(const char* path) {
+  std::vector<uint32_t> t;
+  FILE* f = fopen(path, "r");
+  if (!f) return t;
+  unsigned long v;
+  while (fscanf(f, "%lu", &v) == 1) t.push_back((uint32_t)v);
+  fclose(f);
+  return t;
+}
+
+// Whole-revolution sequence: every spoke of a frame, colour ramps that move per frame
+static MockFile syntheticFseq(const BenchArgs& a) {
+  FseqBuildCfg c;
+  c.chans = (uint32_t)a.arms * a.pixels * 3u * a.spokes;
+  c.frames = a.frames;
+  c.compType = a.comp;
+  c.framesPerBlock = a.fpb;
+  std::vector<uint8_t> d((size_t)c.chans * c.frames);
+  uint32_t x = 0x2545F491u;
+  for (size_t i = 0; i < d.size(); ++i) {
+    x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+    d[i] = (uint8_t)((i / 3 + i / c.chans * 5) & 0xF0) | (uint8_t)(x & 0x0F);   // compressible, not trivial
+  }
+  return MockFile(fseqBuild(c, d));
+}
+
+static inline uint64_t nowNs() {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void printHist(const char* name, const LatencyHist& h, const char* unit) {
+  printf("  %-16s n=%-8lu mean=%-8lu p50=%-8lu p99=%-8lu max=%lu %s\n", name, (unsigned long)h.count(),
+         (unsigned long)h.mean(), (unsigned long)h.percentile(50), (unsigned long)h.percentile(99),
+         (unsigned long)h.max(), unit);
+}
+
+int main(int argc, char** argv) {
+  BenchArgs a;
+  if (!parseArgs(argc, argv, a)) return 2;
+
+  MockFile file = a.fseq ? MockFile::load(a.fseq) : syntheticFseq(a);
+  if (!file) { fprintf(stderr, "cannot read %s\n", a.fseq ? a.fseq : "(synthetic)"); return 1; }
+  FseqReader reader;
+  if (const char* err = reader.open(file)) { fprintf(stderr, "open: %s\n", err); return 1; }
+  reader.file().setCost(a.sd);
+  const FseqHeader& h = reader.header();
+
+  // Offset rows for every (arm, slice), as buildPixelLut() does
+  bool perSpokeFrame; uint32_t chPerSpoke;
+  pixelFrameLayout(h.channelCount, a.arms, a.pixels, a.spokes, perSpokeFrame, chPerSpoke);
+  const uint16_t slices = perSpokeFrame ? 1 : a.spokes;
+  std::vector<int32_t> rows((size_t)a.arms * slices * a.pixels);
+  bool dense = true;
+  for (uint8_t arm = 0; arm < a.arms; ++arm)
+    for (uint16_t sl = 0; sl < slices; ++sl)
+      if (!pixelRowOffsets((uint32_t)arm * a.pixels * 3u, sl, chPerSpoke, a.pixels, h.channelCount,
+                           [&](uint32_t ch) { return reader.translate(ch); },
+                           &rows[((size_t)arm * slices + sl) * a.pixels])) dense = false;
+  const SpokeKernel kernel = pickSpokeKernel(MAP_RGB, !dense, false, false);
+
+  // Two arms per lane, as the SPI wiring
+  const uint8_t nLanes = (uint8_t)((a.arms + 1) / 2);
+  std::vector<LaneOutput> lanes(nLanes);
+  std::vector<CountingSink*> sinks;
+  for (auto& l : lanes) {
+    CountingSink* s = new CountingSink(a.spiHz);
+    sinks.push_back(s);
+    if (!l.begin(s, (uint16_t)(2 * a.pixels))) { fprintf(stderr, "lane setup failed\n"); return 1; }
+  }
+
+  // Frame producer: a ring of loaded frames on its own timeline
+  struct Slot { uint64_t abs; uint32_t readyUs; std::vector<uint8_t> buf; };
+  std::vector<Slot> ring;
+  uint64_t nextLoad = 0, shown = 0;
+  uint32_t prodFreeUs = 1000;                       // producer busy until (or blocked on a full ring since)
+  std::vector<uint8_t> onAir(h.channelCount, 0);
+  LatencyHist loadUs, paintNs, spokeUs;
+  uint32_t underruns = 0, missed = 0, loadFails = 0;
+
+  auto pump = [&](uint32_t nowUs) {
+    while (ring.size() < RING && (int32_t)(prodFreeUs - nowUs) <= 0) {
+      const uint32_t start = prodFreeUs;
+      Slot s; s.abs = nextLoad++; s.buf.resize(h.channelCount);
+      const uint32_t t0 = micros();
+      const uint64_t c0 = nowNs();
+      if (!reader.loadFrame((uint32_t)(s.abs % h.frameCount), s.buf.data())) ++loadFails;
+      const uint32_t cpuUs = (uint32_t)((nowNs() - c0) * a.cpuScale / 1000.0);
+      const uint32_t sdUs = micros() - t0;
+      mockSetUs(t0);                                // the producer's time is not the render loop's
+      loadUs.add(sdUs + cpuUs);
+      prodFreeUs = start + sdUs + cpuUs;
+      s.readyUs = prodFreeUs;
+      ring.push_back(std::move(s));
+    }
+  };
+
+  RotationSimCfg sc;
+  sc.rpm = a.rpm;
+  std::vector<uint32_t> trace;
+  if (a.trace) {
+    trace = loadTrace(a.trace);
+    if (trace.size() < 2) { fprintf(stderr, "trace %s: need 2+ sync times\n", a.trace); return 1; }
+    sc.trace = trace.data(); sc.traceLen = (uint32_t)trace.size();
+  }
+  mockSetUs(1000);
+  RotationSim sim;      sim.start(micros(), sc);
+  AngleEstimator angle;
+  SpokeScheduler sched; sched.reset();
+  FrameClock clock;     clock.setRate((uint32_t)(h.stepTimeMs ? h.stepTimeMs : 25) * 1000u, 1);
+  uint16_t spokeBase[8];
+  for (uint8_t arm = 0; arm < a.arms; ++arm) spokeBase[arm] = (uint16_t)((uint32_t)arm * a.spokes / a.arms);
+
+  auto paintAndCommit = [&](uint16_t step, uint32_t startUs) {
+    const uint64_t c0 = nowNs();
+    const uint16_t slice0 = perSpokeFrame ? 0 : step;
+    for (uint8_t arm = 0; arm < a.arms; ++arm) {
+      const uint16_t slice = perSpokeFrame ? 0 : (uint16_t)((slice0 + spokeBase[arm]) % a.spokes);
+      uint8_t* dst = lanes[arm / 2].wordsAt((uint16_t)((arm % 2) * a.pixels), a.pixels);
+      kernel(onAir.data(), &rows[((size_t)arm * slices + slice) * a.pixels], a.pixels, nullptr, 0xFF, dst);
+    }
+    const uint64_t ns = nowNs() - c0;
+    paintNs.add((uint32_t)(ns * a.cpuScale));
+    mockAdvanceUs((uint32_t)(ns * a.cpuScale / 1000.0));
+    for (auto& l : lanes) l.show();                 // waits for the previous transfer (stall)
+    const uint32_t lat = micros() - startUs;
+    spokeUs.add(lat);
+    if (lat >= sched.spokeUs()) ++missed;
+  };
+
+  // The render loop also polls the frame clock between spokes (slow rotors)
+  const uint32_t stepUs = clock.periodNum() / clock.periodDen();
+  uint32_t frameTickUs = micros() + stepUs;
+  clock.start(micros());
+
+  const uint32_t wantPulses = a.revs * sc.ppr;
+  while (sim.pulses() < wantPulses) {
+    // Next event: a Hall pulse, a spoke start or a frame boundary
+    uint32_t at = sim.nextUs();
+    if (sched.running() && (int32_t)(sched.nextSpokeUs() - at) < 0) at = sched.nextSpokeUs();
+    if ((int32_t)(frameTickUs - at) < 0) at = frameTickUs;
+    mockAdvanceTo(at);
+    const uint32_t now = micros();
+    while (usReached(now, frameTickUs)) frameTickUs += stepUs;
+
+    pump(now);
+    const uint32_t due = clock.advance(now);
+    if (due) {
+      const uint64_t want = shown + due;
+      while (!ring.empty() && ring.front().abs <= want && (int32_t)(ring.front().readyUs - now) <= 0) {
+        if (ring.size() == RING && (int32_t)(prodFreeUs - now) < 0) prodFreeUs = now;   // room again
+        shown = ring.front().abs;
+        onAir.swap(ring.front().buf);
+        ring.erase(ring.begin());
+      }
+      if (shown < want) {                           // frame not loaded in time: the show drops it
+        underruns += (uint32_t)(want - shown);
+        shown = want;
+        if (nextLoad <= want) {
+          ring.clear(); nextLoad = want + 1;
+          if ((int32_t)(prodFreeUs - now) < 0) prodFreeUs = now;
+        }
+      }
+      pump(now);
+    }
+
+    uint32_t pulseUs;
+    if (sim.due(now, pulseUs)) {
+      if (angle.update(pulseUs) && angle.hasPeriod()) {
+        sched.sync(angle.syncUs(), angle.spokeUs(a.spokes), a.spokes);
+        paintAndCommit(0, now);
+      }
+      continue;
+    }
+    uint16_t step; uint32_t startUs;
+    if (sched.spokeDue(now, step, startUs)) paintAndCommit(step, startUs);
+  }
+
+  uint64_t wireBytes = 0, wireUs = 0, stallUs = 0;
+  for (auto* s : sinks) { wireBytes += s->bytes(); wireUs += s->wireUsTotal(); stallUs += s->stallUs(); }
+  const double simSec = (double)(uint32_t)(micros() - 1000) / 1e6;
+  printf("render_bench: %u arms x %u px, %u spokes, %.0f rpm%s, %s, %u frames x %lu ch (%s, %u blocks)\n",
+         (unsigned)a.arms, (unsigned)a.pixels, (unsigned)a.spokes, a.rpm, a.trace ? " (trace)" : "",
+         perSpokeFrame ? "one spoke per frame" : "all spokes per frame", (unsigned)h.frameCount,
+         (unsigned long)h.channelCount, h.compType == 1 ? "zstd" : h.compType == 2 ? "zlib" : "raw",
+         (unsigned)reader.blocks());
+  printf("  simulated %.2f s, spoke budget %lu us, sd %lu kB/s + %lu us/req, spi %lu Hz, cpu x%.2f\n",
+         simSec, (unsigned long)sched.spokeUs(), (unsigned long)a.sd.kBps, (unsigned long)a.sd.requestUs,
+         (unsigned long)a.spiHz, a.cpuScale);
+  printHist("spoke latency", spokeUs, "us");
+  printHist("paint", paintNs, "ns");
+  printHist("frame load", loadUs, "us");
+  printf("  missed deadlines %lu, skipped spokes %lu, ring underruns %lu, load errors %lu\n",
+         (unsigned long)missed, (unsigned long)sched.skipped(), (unsigned long)underruns, (unsigned long)loadFails);
+  printf("  sd reads %lu (%llu kB, %llu ms busy), lanes %llu kB on the wire, %llu ms wire, %llu ms stalled\n",
+         (unsigned long)reader.file().stats().reads, (unsigned long long)(reader.file().stats().bytes / 1024),
+         (unsigned long long)(reader.file().stats().busyUs / 1000), (unsigned long long)(wireBytes / 1024),
+         (unsigned long long)(wireUs / 1000), (unsigned long long)(stallUs / 1000));
+  return loadFails ? 1 : 0;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "LaneOutput.h"
+#include "MockClock.h"
+
+// Lane back end for host runs: keeps the last frame sent and counts frames
+// and bytes.  A transfer occupies the simulated wire for len * 8 / hz; as on
+// the SPI DMA sink, waitDone() blocks (advances the mock clock) until it has
+// left, so the harness sees output stalls where the device would.
+
+class CountingSink : public LaneSink {
+public:
+  explicit CountingSink(uint32_t hz = 20000000) : _hz(hz ? hz : 1) {}
+
+  bool begin(size_t maxBytes) override { _last.reserve(maxBytes); return true; }
+  bool transmit(const uint8_t* buf, size_t len) override {
+    waitDone();
+    _last.assign(buf, buf + len);
+    ++_frames; _bytes += len;
+    const uint32_t us = wireUs(len);
+    _busyUntil = micros() + us;
+    _wireUs += us;
+    return true;
+  }
+  void waitDone() override {
+    const uint32_t now = micros();
+    if ((int32_t)(_busyUntil - now) > 0) { _stallUs += _busyUntil - now; mockAdvanceTo(_busyUntil); }
+  }
+  const char* name() const override { return "counting"; }
+
+  uint32_t wireUs(size_t len) const { return (uint32_t)((uint64_t)len * 8u * 1000000u / _hz); }
+  bool     busy() const             { return (int32_t)(_busyUntil - micros()) > 0; }
+
+  const std::vector<uint8_t>& last() const { return _last; }
+  uint32_t frames()  const { return _frames; }
+  uint64_t bytes()   const { return _bytes; }
+  uint64_t wireUsTotal() const { return _wireUs; }
+  uint64_t stallUs() const { return _stallUs; }
+
+private:
+  uint32_t _hz;
+  std::vector<uint8_t> _last;
+  uint32_t _frames = 0;
+  uint64_t _bytes = 0, _wireUs = 0, _stallUs = 0;
+  uint32_t _busyUntil = 0;
+};
@@ -0,0 +1,16 @@
+#pragma once
+#include <stdint.h>
+
+// Simulated micros() for host builds.  Time only moves when the harness (or a
+// mock back end modelling a slow device, see MockFile and CountingSink)
+// advances it, so runs are repeatable and independent of the host's speed.
+// Wraps like the device's 32-bit microsecond clock.
+
+inline uint32_t& mockClockUs() { static uint32_t t = 0; return t; }
+
+static inline uint32_t micros()                  { return mockClockUs(); }
+static inline uint32_t millis()                  { return mockClockUs() / 1000u; }
+static inline void     mockSetUs(uint32_t t)     { mockClockUs() = t; }
+static inline void     mockAdvanceUs(uint32_t d) { mockClockUs() += d; }
+// Move forward to t; never backwards (an event already in the past is "now")
+static inline void     mockAdvanceTo(uint32_t t) { if ((int32_t)(t - mockClockUs()) > 0) mockClockUs() = t; }
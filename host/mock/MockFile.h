@@ -0,0 +1,93 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <memory>
+#include <vector>
+#include "MockClock.h"
+
+// The part of the Arduino FS File API the player uses, over an in-memory byte
+// buffer.  Copies share the buffer, as File handles share the open file.
+// Each read() can charge a simple SD cost model to the mock clock: a fixed
+// per-request latency plus the transfer at a given bus rate.
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+struct MockSdCost {
+  uint32_t requestUs = 0;    // command + card access per read()
+  uint32_t kBps      = 0;    // transfer rate, kB/s (0 = free)
+};
+
+struct MockSdStats {
+  uint32_t reads = 0, seeks = 0;
+  uint64_t bytes = 0, busyUs = 0;
+};
+
+class MockFile {
+public:
+  MockFile() {}
+  explicit MockFile(std::vector<uint8_t> data)
+    : _data(std::make_shared<std::vector<uint8_t>>(std::move(data))) {}
+
+  // Whole file from disk; an invalid (false) file if it cannot be read
+  static MockFile load(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return MockFile();
+    std::vector<uint8_t> d;
+    uint8_t buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) d.insert(d.end(), buf, buf + n);
+    fclose(f);
+    return MockFile(std::move(d));
+  }
+
+  explicit operator bool() const { return _data != nullptr; }
+  void     close()               { _data.reset(); _pos = 0; }
+  size_t   size() const          { return _data ? _data->size() : 0; }
+  size_t   position() const      { return _pos; }
+  int      available() const     { return (int)(size() - _pos); }
+
+  bool seek(uint64_t pos, SeekMode mode = SeekSet) {
+    if (!_data) return false;
+    uint64_t p = pos;
+    if (mode == SeekCur) p = _pos + pos;
+    else if (mode == SeekEnd) p = _data->size() + pos;
+    if (p > _data->size()) return false;
+    if (p != _pos) ++_stats.seeks;
+    _pos = (size_t)p;
+    return true;
+  }
+
+  size_t read(uint8_t* buf, size_t len) {
+    if (!_data) return 0;
+    const size_t n = (_pos + len <= _data->size()) ? len : _data->size() - _pos;
+    memcpy(buf, _data->data() + _pos, n);
+    _pos += n;
+    const uint32_t us = _cost.requestUs + (_cost.kBps ? (uint32_t)((uint64_t)n * 1000u / _cost.kBps) : 0);
+    mockAdvanceUs(us);
+    ++_stats.reads; _stats.bytes += n; _stats.busyUs += us;
+    return n;
+  }
+
+  size_t write(const uint8_t* buf, size_t len) {
+    if (!_data) return 0;
+    if (_pos + len > _data->size()) _data->resize(_pos + len);
+    memcpy(_data->data() + _pos, buf, len);
+    _pos += len;
+    return len;
+  }
+
+  void setCost(const MockSdCost& c)  { _cost = c; }
+  const MockSdStats& stats() const   { return _stats; }
+  void resetStats()                  { _stats = MockSdStats(); }
+  const std::vector<uint8_t>* bytes() const { return _data.get(); }
+
+private:
+  std::shared_ptr<std::vector<uint8_t>> _data;
+  size_t      _pos = 0;
+  MockSdCost  _cost;
+  MockSdStats _stats;
+};
+
+typedef MockFile File;
@@ -0,0 +1,21 @@
+#pragma once
+#include <stdio.h>
+
+// Minimal check macros for the host tests: every failed CHECK is printed and
+// counted, main() returns the count (non-zero fails the ctest).
+
+inline int& hostTestFailures() { static int n = 0; return n; }
+
+#define CHECK(cond) do { if (!(cond)) { \
+    fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); ++hostTestFailures(); } } while (0)
+#define CHECK_EQ(a, b) do { const long long _a = (long long)(a), _b = (long long)(b); if (_a != _b) { \
+    fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, #a, #b, _a, _b); \
+    ++hostTestFailures(); } } while (0)
+
+#define RUN(test) do { const int _before = hostTestFailures(); test(); \
+    printf("%-32s %s\n", #test, hostTestFailures() == _before ? "ok" : "FAILED"); } while (0)
+
+inline int hostTestResult() {
+  if (hostTestFailures()) fprintf(stderr, "%d check(s) failed\n", hostTestFailures());
+  return hostTestFailures() ? 1 : 0;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include "SpokeKernels.h"
+
+// Synthetic spoke shared by the kernel test and bench: a random frame, the
+// offset row of n pixels (every 7th a hole when sparse) and a level table.
+struct KernelFixture {
+  std::vector<uint8_t> frame;
+  std::vector<int32_t> offs;
+  uint8_t lvl[256];
+  uint8_t hdr = 0xFF;
+
+  KernelFixture(uint16_t n, bool sparse, bool levels) : frame((size_t)n * 3), offs(n) {
+    uint32_t x = 0x9E3779B9u;
+    for (auto& b : frame) { x ^= x << 13; x ^= x >> 17; x ^= x << 5; b = (uint8_t)x; }
+    for (uint16_t i = 0; i < n; ++i) offs[i] = (sparse && (i % 7) == 3) ? -1 : (int32_t)i * 3;
+    for (int v = 0; v < 256; ++v) lvl[v] = levels ? (uint8_t)((v * v + 254) / 255 * 3 / 4) : (uint8_t)v;
+    if (levels) hdr = 0xE0 | 20;
+  }
+};
+
+static const ColorMap KERNEL_MAPS[] = { MAP_RGB, MAP_RBG, MAP_GBR, MAP_GRB, MAP_BRG, MAP_BGR };
+static const char* const KERNEL_MAP_NAMES[] = { "RGB", "RBG", "GBR", "GRB", "BRG", "BGR" };
@@ -0,0 +1,19 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include "RotationSim.h"
+
+// Hall sync traces for the replay tool and test, generated with RotationSim:
+// the same pulses /bench feeds the device when it simulates a rotor.
+static inline std::vector<uint32_t> simulatedTrace(const RotationSimCfg& cfg, uint32_t syncs, uint32_t t0 = 1000) {
+  std::vector<uint32_t> ts;
+  RotationSim sim;
+  sim.start(t0, cfg);
+  uint32_t now = t0, t;
+  while (ts.size() < syncs) {
+    now = sim.nextUs() + cfg.jitterUs + 1;   // past the next pulse and its jitter
+    while (sim.due(now, t)) ts.push_back(t);
+  }
+  ts.resize(syncs);
+  return ts;
+}
@@ -0,0 +1,87 @@
+// Parallel output transposer: round trip, bit layout against a per-bit
+// reference, and real SK9822 arm streams recovered line by line off the bus.
+#include <string.h>
+#include <vector>
+#include "BitTranspose.h"
+#include "LaneOutput.h"
+#include "HostTest.h"
+
+static uint32_t rng = 0x12345678u;
+static uint8_t nextByte() { rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5; return (uint8_t)rng; }
+
+static void testSelfTest() { CHECK(bitTransposeSelfTest()); }
+
+static void testRoundTrip() {
+  const size_t lengths[] = { 1, 2, 37, 580, 4101 };
+  for (uint8_t lanes = 1; lanes <= 8; ++lanes) {
+    for (size_t bytes : lengths) {
+      std::vector<std::vector<uint8_t>> in(lanes, std::vector<uint8_t>(bytes)), back(lanes, std::vector<uint8_t>(bytes));
+      const uint8_t* src[8] = { nullptr };
+      uint8_t* dst[8] = { nullptr };
+      for (uint8_t k = 0; k < lanes; ++k) {
+        for (auto& b : in[k]) b = nextByte();
+        src[k] = in[k].data(); dst[k] = back[k].data();
+      }
+      std::vector<uint8_t> bus(bytes * 8);
+      transposeStreams8(src, lanes, bytes, bus.data());
+      untransposeStreams8(bus.data(), bytes, lanes, dst);
+      for (uint8_t k = 0; k < lanes; ++k) CHECK(in[k] == back[k]);
+      // Lines above `lanes` stay low
+      const uint8_t unused = (uint8_t)(lanes == 8 ? 0 : (0xFF << lanes));
+      bool low = true;
+      for (uint8_t w : bus) if (w & unused) low = false;
+      CHECK(low);
+    }
+  }
+}
+
+static void testBitLayout() {
+  // bit k of bus byte j*8+b == bit (7-b) of stream k's byte j (MSB first)
+  const size_t bytes = 64;
+  std::vector<std::vector<uint8_t>> in(8, std::vector<uint8_t>(bytes));
+  const uint8_t* src[8];
+  for (int k = 0; k < 8; ++k) { for (auto& b : in[k]) b = nextByte(); src[k] = in[k].data(); }
+  src[5] = nullptr;                                   // unused line: zeros
+  std::vector<uint8_t> bus(bytes * 8);
+  transposeStreams8(src, 8, bytes, bus.data());
+  for (size_t j = 0; j < bytes; ++j)
+    for (int b = 0; b < 8; ++b)
+      for (int k = 0; k < 8; ++k) {
+        const int want = (k == 5) ? 0 : (in[k][j] >> (7 - b)) & 1;
+        CHECK_EQ((bus[j * 8 + b] >> k) & 1, want);
+      }
+}
+
+static void testArmStreams() {
+  // Four arms of SK9822 wire bytes, as ParallelOutput keeps them
+  const uint16_t leds = 144;
+  const size_t armBytes = LaneOutput::wireBytesFor(leds);
+  std::vector<std::vector<uint8_t>> arm(4, std::vector<uint8_t>(armBytes));
+  const uint8_t* src[4];
+  for (int a = 0; a < 4; ++a) {
+    LaneOutput::initWire(arm[a].data(), leds);
+    for (uint16_t i = 0; i < leds; ++i) {
+      uint8_t* p = arm[a].data() + LaneOutput::START_BYTES + (size_t)i * 4;
+      p[1] = nextByte(); p[2] = nextByte(); p[3] = nextByte();
+    }
+    src[a] = arm[a].data();
+  }
+  std::vector<uint8_t> bus(armBytes * 8);
+  transposeStreams8(src, 4, armBytes, bus.data());
+  // One bus word per clock: a 4-arm spoke takes as many clocks as one arm's bits
+  CHECK_EQ(bus.size(), armBytes * 8);
+  // Each data line, sampled MSB first on every clock, is that arm's serial stream
+  for (int a = 0; a < 4; ++a) {
+    std::vector<uint8_t> line(armBytes, 0);
+    for (size_t c = 0; c < bus.size(); ++c) line[c / 8] = (uint8_t)((line[c / 8] << 1) | ((bus[c] >> a) & 1));
+    CHECK(line == arm[a]);
+  }
+}
+
+int main() {
+  RUN(testSelfTest);
+  RUN(testRoundTrip);
+  RUN(testBitLayout);
+  RUN(testArmStreams);
+  return hostTestResult();
+}
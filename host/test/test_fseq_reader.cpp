@@ -0,0 +1,165 @@
+// FSEQ reader on a mock SD file: header, block tables, sparse translation and
+// per-frame content for raw, zstd and zlib sequences, plus the pixel mapping.
+#include <stdint.h>
+#include <vector>
+#include "FseqReader.h"
+#include "FseqWriter.h"
+#include "PixelMap.h"
+#include "HostTest.h"
+
+static std::vector<uint8_t> pattern(uint32_t chans, uint32_t frames) {
+  std::vector<uint8_t> d((size_t)chans * frames);
+  for (size_t i = 0; i < d.size(); ++i) d[i] = (uint8_t)(i * 7 + i / chans * 13);
+  return d;
+}
+
+// Open cfg's image and compare frames in order, then a few random seeks
+static void checkRoundTrip(const FseqBuildCfg& cfg) {
+  const std::vector<uint8_t> data = pattern(cfg.chans, cfg.frames);
+  const std::vector<uint8_t> img = fseqBuild(cfg, data);
+  CHECK(!img.empty());
+  FseqReader r;
+  const char* err = r.open(MockFile(img));
+  CHECK(err == nullptr);
+  if (err) { fprintf(stderr, "  open: %s\n", err); return; }
+  CHECK_EQ(r.header().channelCount, cfg.chans);
+  CHECK_EQ(r.header().frameCount, cfg.frames);
+  CHECK_EQ(r.header().compType, cfg.compType);
+  std::vector<uint8_t> f(cfg.chans);
+  for (uint32_t i = 0; i < cfg.frames; ++i) {
+    CHECK(r.loadFrame(i, f.data()));
+    CHECK(memcmp(f.data(), &data[(size_t)i * cfg.chans], cfg.chans) == 0);
+  }
+  if (cfg.compType) {
+    const uint32_t blocks = (cfg.frames + cfg.framesPerBlock - 1) / cfg.framesPerBlock;
+    CHECK_EQ(r.blocks(), blocks);
+    CHECK_EQ(r.blockReads(), blocks);          // sequential play inflates each block once
+  }
+  const uint32_t seeks[] = { cfg.frames - 1, 0, cfg.frames / 2, 1, cfg.frames - 1 };
+  for (uint32_t i : seeks) {
+    CHECK(r.loadFrame(i, f.data()));
+    CHECK(memcmp(f.data(), &data[(size_t)i * cfg.chans], cfg.chans) == 0);
+  }
+  CHECK(!r.loadFrame(cfg.frames, f.data()));
+}
+
+static void testRaw() {
+  FseqBuildCfg c; c.chans = 3 * 144 * 2; c.frames = 20;
+  checkRoundTrip(c);
+}
+
+static void testZstdFrameNumberTable() {
+  FseqBuildCfg c; c.chans = 999; c.frames = 37; c.compType = 1; c.framesPerBlock = 8; c.padEntries = 5;
+  checkRoundTrip(c);
+}
+
+static void testZstdPerFrame() {
+  FseqBuildCfg c; c.chans = 600; c.frames = 12; c.compType = 1; c.framesPerBlock = 1;
+  checkRoundTrip(c);
+}
+
+static void testZstdLargeBlock() {   // frames spanning several 128 KB zstd blocks
+  FseqBuildCfg c; c.chans = 3 * 1024 * 4; c.frames = 24; c.compType = 1; c.framesPerBlock = 12;
+  checkRoundTrip(c);
+}
+
+static void testZstdSizeTable() {
+  FseqBuildCfg c; c.chans = 90; c.frames = 30; c.compType = 1; c.framesPerBlock = 7; c.sizeTable = true;
+  checkRoundTrip(c);
+}
+
+static void testZlib() {
+#if defined(FSEQ_HOST_ZLIB)
+  FseqBuildCfg c; c.chans = 432; c.frames = 25; c.compType = 2; c.framesPerBlock = 10;
+  checkRoundTrip(c);
+#else
+  printf("  (no zlib on this host, skipped)\n");
+#endif
+}
+
+static void testBadFiles() {
+  FseqBuildCfg c; c.chans = 30; c.frames = 4;
+  std::vector<uint8_t> img = fseqBuild(c, pattern(c.chans, c.frames));
+  FseqReader r;
+  std::vector<uint8_t> bad = img; bad[0] = 'X';
+  CHECK(strcmp(r.open(MockFile(bad)), "bad magic") == 0);
+  CHECK(strcmp(r.open(MockFile(std::vector<uint8_t>(img.begin(), img.begin() + 10))), "short") == 0);
+  CHECK(strcmp(r.open(MockFile()), "open fail") == 0);
+
+  // Legacy size table whose blocks do not add up to the frame count
+  FseqBuildCfg z; z.chans = 30; z.frames = 10; z.compType = 1; z.framesPerBlock = 5; z.sizeTable = true;
+  img = fseqBuild(z, pattern(z.chans, z.frames));
+  img[14] = 11;   // frameCount low byte
+  CHECK(strcmp(r.open(MockFile(img)), "block sizes") == 0);
+}
+
+static int64_t bruteTranslate(const std::vector<SparseRange>& ranges, uint32_t ch) {
+  uint32_t accum = 0;
+  for (const SparseRange& r : ranges) {
+    if (ch >= r.start && ch < r.start + r.count) return accum + (ch - r.start);
+    accum += r.count;
+  }
+  return -1;
+}
+
+static void checkSparse(const std::vector<SparseRange>& ranges, uint8_t wantMode) {
+  FseqBuildCfg c; c.ranges = ranges; c.frames = 3;
+  for (const SparseRange& r : ranges) c.chans += r.count;
+  FseqReader r;
+  CHECK(r.open(MockFile(fseqBuild(c, pattern(c.chans, c.frames)))) == nullptr);
+  CHECK_EQ(r.sparseMode(), wantMode);
+  for (uint32_t ch = 0; ch < 4000; ++ch) CHECK_EQ(r.translate(ch), bruteTranslate(ranges, ch));
+}
+
+static void testSparse() {
+  std::vector<SparseRange> few = { { 300, 30, 0 }, { 0, 60, 0 }, { 1000, 12, 0 } };
+  checkSparse(few, XLATE_LINEAR);
+  std::vector<SparseRange> many;
+  for (uint32_t i = 0; i < 40; ++i) many.push_back({ (i * 37) % 40 * 90, 45, 0 });   // shuffled, gaps
+  checkSparse(many, XLATE_BSEARCH);
+  many[5].count = 200;                                                             // now overlaps
+  checkSparse(many, XLATE_LINEAR);
+  FseqBuildCfg c; c.chans = 90; c.frames = 2;
+  FseqReader r;
+  CHECK(r.open(MockFile(fseqBuild(c, pattern(c.chans, c.frames)))) == nullptr);
+  CHECK_EQ(r.sparseMode(), XLATE_DENSE);
+  CHECK_EQ(r.translate(89), 89);
+  CHECK_EQ(r.translate(90), -1);
+}
+
+static void testPixelMap() {
+  bool perSpoke; uint32_t chPerSpoke;
+  pixelFrameLayout(2 * 100 * 3, 2, 100, 40, perSpoke, chPerSpoke);
+  CHECK(perSpoke); CHECK_EQ(chPerSpoke, 600);
+  pixelFrameLayout(2 * 100 * 3 * 40, 2, 100, 40, perSpoke, chPerSpoke);
+  CHECK(!perSpoke); CHECK_EQ(chPerSpoke, 600);
+
+  // Arm 1 of spoke 3 in a sparse file that drops every other 30-channel run
+  std::vector<SparseRange> ranges;
+  uint32_t accum = 0;
+  for (uint32_t s = 0; s < 255 * 60; s += 60) { ranges.push_back({ s, 30, accum }); accum += 30; }
+  std::vector<SparseRange> sorted(ranges.size());
+  const uint8_t mode = fseqIndexSparse(ranges.data(), (uint8_t)ranges.size(), sorted.data());
+  const uint8_t n = (uint8_t)ranges.size();
+  auto xl = [&](uint32_t ch) { return fseqSparseTranslate(mode, ranges.data(), sorted.data(), n, accum, ch); };
+  int32_t row[100];
+  const bool dense = pixelRowOffsets(300, 3, 600, 100, accum, xl, row);
+  CHECK(!dense);
+  for (uint16_t i = 0; i < 100; ++i) {
+    const int64_t want = xl(300 + 3 * 600 + i * 3u);
+    CHECK_EQ(row[i], (want >= 0 && want + 2 < (int64_t)accum) ? want : -1);
+  }
+}
+
+int main() {
+  RUN(testRaw);
+  RUN(testZstdFrameNumberTable);
+  RUN(testZstdPerFrame);
+  RUN(testZstdLargeBlock);
+  RUN(testZstdSizeTable);
+  RUN(testZlib);
+  RUN(testBadFiles);
+  RUN(testSparse);
+  RUN(testPixelMap);
+  return hostTestResult();
+}
@@ -0,0 +1,55 @@
+// Latency histograms: bucket edges, percentiles, and the cycle-count range.
+#include "LatencyHist.h"
+#include "HostTest.h"
+
+static void testBuckets() {
+  LatencyHist h;
+  h.add(0); h.add(1); h.add(2); h.add(3); h.add(1000);
+  CHECK_EQ(h.bucket(0), 1);
+  CHECK_EQ(h.bucket(1), 1);
+  CHECK_EQ(h.bucket(2), 2);
+  CHECK_EQ(h.bucket(10), 1);            // [512, 1024)
+  CHECK_EQ(h.count(), 5);
+  CHECK_EQ(h.min(), 0);
+  CHECK_EQ(h.max(), 1000);
+  CHECK_EQ(LatencyHist::upper(10), 1024);
+  CHECK_EQ(LatencyHist::upper(LatencyHist::BUCKETS - 1), UINT32_MAX);
+}
+
+static void testPercentiles() {
+  LatencyHist h;
+  for (int i = 0; i < 99; ++i) h.add(100);
+  h.add(5000);
+  CHECK_EQ(h.percentile(50), 127);      // top of [64, 128)
+  CHECK_EQ(h.percentile(99), 127);
+  CHECK_EQ(h.percentile(100), 5000);    // capped at max
+}
+
+static void testCycleRange() {
+  // 240 MHz: a 50 ms SD lock wait is 12M cycles, 2 s is 480M
+  const uint32_t slow = 12000000u, verySlow = 480000000u;
+  LatencyHist us;
+  CycleHist cyc;
+  for (int i = 0; i < 98; ++i) { us.add(24000); cyc.add(24000); }   // 100 us
+  us.add(slow); cyc.add(slow);
+  us.add(verySlow); cyc.add(verySlow);
+  // 24 buckets end at 2^23 (35 ms of cycles): both slow samples share the
+  // catch-all and p99 can only report max()
+  CHECK_EQ(us.bucket(LatencyHist::BUCKETS - 1), 2);
+  CHECK_EQ(us.percentile(99), verySlow);
+  // 32 buckets keep them apart, so p99 is the 50 ms wait's bucket
+  CHECK_EQ(cyc.bucket(24), 1);          // [2^23, 2^24)
+  CHECK_EQ(cyc.bucket(29), 1);          // [2^28, 2^29)
+  CHECK_EQ(cyc.percentile(99), (1u << 24) - 1);
+  CHECK_EQ(CycleHist::upper(30), 1u << 30);
+  CHECK_EQ(CycleHist::upper(31), UINT32_MAX);
+  cyc.add(UINT32_MAX);
+  CHECK_EQ(cyc.bucket(31), 1);
+}
+
+int main() {
+  RUN(testBuckets);
+  RUN(testPercentiles);
+  RUN(testCycleRange);
+  return hostTestResult();
+}
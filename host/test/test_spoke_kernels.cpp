@@ -0,0 +1,63 @@
+// Every spoke kernel instantiation against the per-pixel reference path.
+#include <string.h>
+#include <vector>
+#include "HostTest.h"
+#include "KernelFixture.h"
+
+static void checkKernel(ColorMap cm, bool sparse, bool levels, bool rev, uint16_t n) {
+  KernelFixture fx(n, sparse, levels);
+  std::vector<uint8_t> ref((size_t)n * 4, 0x55), out((size_t)n * 4, 0xAA);
+  spokeKernelGeneric(cm, rev, fx.frame.data(), fx.offs.data(), n, fx.lvl, fx.hdr, ref.data());
+  const SpokeKernel k = pickSpokeKernel(cm, sparse, levels, rev);
+  CHECK(k != nullptr);
+  k(fx.frame.data(), fx.offs.data(), n, fx.lvl, fx.hdr, out.data());
+  if (memcmp(ref.data(), out.data(), ref.size()) != 0) {
+    fprintf(stderr, "  mismatch cm=%d sparse=%d levels=%d rev=%d n=%u\n", (int)cm, sparse, levels, rev, (unsigned)n);
+    CHECK(false);
+  }
+}
+
+static void testAllInstantiations() {
+  const uint16_t sizes[] = { 1, 7, 144, 1024 };
+  for (ColorMap cm : KERNEL_MAPS)
+    for (int cfg = 0; cfg < 8; ++cfg)
+      for (uint16_t n : sizes) checkKernel(cm, cfg & 4, cfg & 2, cfg & 1, n);
+}
+
+static void testSelectionIsDistinct() {
+  // One kernel per (sparse, levels, rev) for a colour map, none shared
+  for (ColorMap cm : KERNEL_MAPS) {
+    SpokeKernel seen[8];
+    for (int cfg = 0; cfg < 8; ++cfg) {
+      seen[cfg] = pickSpokeKernel(cm, cfg & 4, cfg & 2, cfg & 1);
+      for (int j = 0; j < cfg; ++j) CHECK(seen[j] != seen[cfg]);
+    }
+  }
+}
+
+static void testIdentityLevels() {
+  uint8_t lvl[256];
+  for (int v = 0; v < 256; ++v) lvl[v] = (uint8_t)v;
+  CHECK(levelsAreIdentity(lvl, 0xFF));
+  CHECK(!levelsAreIdentity(lvl, 0xE0 | 16));
+  lvl[200] = 199;
+  CHECK(!levelsAreIdentity(lvl, 0xFF));
+}
+
+static void testSparseHolesAreBlack() {
+  KernelFixture fx(14, true, false);
+  std::vector<uint8_t> out(14 * 4);
+  pickSpokeKernel(MAP_RGB, true, false, false)(fx.frame.data(), fx.offs.data(), 14, nullptr, 0xFF, out.data());
+  for (uint16_t i : { 3, 10 }) {
+    CHECK_EQ(out[i * 4], 0xFF);
+    CHECK_EQ(out[i * 4 + 1] | out[i * 4 + 2] | out[i * 4 + 3], 0);
+  }
+}
+
+int main() {
+  RUN(testAllInstantiations);
+  RUN(testSelectionIsDistinct);
+  RUN(testIdentityLevels);
+  RUN(testSparseHolesAreBlack);
+  return hostTestResult();
+}